@@ -4,6 +4,7 @@ const int interruptPin = 4;
 uint8_t  intStatus = 0;
 bool presSign = false, motSign = false;
 caliPile sensor(interruptPin);
+caliPileSnapshot snapshot;
 
 void inthandler() {
   newInt = true;
@@ -29,9 +30,12 @@ void setup() {
 
 void loop() {
 
-  Serial.print(sensor.calcAmbientTemp(sensor.getAmbientTemp()));
+  sensor.readSnapshot(snapshot);  // one bus transaction for all result registers
+  float ambient = sensor.calcAmbientTemp(snapshot.ambientTemp());
+
+  Serial.print(ambient);
   Serial.print("  ");
-  Serial.print(sensor.calcObjectTemp(sensor.getObjectTemp(), sensor.calcAmbientTemp(sensor.getAmbientTemp())));
+  Serial.print(sensor.calcObjectTemp(snapshot.objectTemp(), ambient));
   Serial.println("  ");
   delay(100);
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "caliPile.h"
+#include "caliPileScheduler.h"
+
+// Samples fast while someone is in the room and backs off when it is empty.
+// At the slow levels the presence and motion interrupts wake the host.
+const int interruptPin = 4;
+caliPile sensor(interruptPin);
+caliPileScheduler scheduler(sensor);
+caliPileSnapshot snapshot;
+
+void onInterrupt() {
+  scheduler.wake();
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+  sensor.TempCalculations();
+
+  scheduler.setHysteresis(2, 30000);
+  scheduler.begin();
+  attachInterrupt(digitalPinToInterrupt(interruptPin), onInterrupt, FALLING);
+}
+
+void loop() {
+  if (scheduler.service(snapshot)) {
+    float ambient = sensor.calcAmbientTemp(snapshot.ambientTemp());
+
+    Serial.print(scheduler.level());
+    Serial.print("  ");
+    Serial.print(sensor.calcObjectTemp(snapshot.objectTemp(), ambient));
+    Serial.print("  ");
+    Serial.println(snapshot.presenceStat());
+  }
+
+  // A battery build would sleep here for scheduler.millisUntilDue() ms or
+  // until the INT pin falls
+}
@@ -0,0 +1,57 @@
+#include "caliPile.h"
+
+// Brings a sensor up and samples it without ever blocking loop().
+// Each poll() issues at most one I2C transaction and returns at once.
+const int interruptPin = 4;
+const int ledPin = LED_BUILTIN;
+caliPile sensor(interruptPin);
+caliPileSnapshot snapshot;
+uint32_t lastSample = 0;
+uint32_t lastBlink = 0;
+
+void onComplete(caliPile &done, uint8_t operation) {
+  switch (operation) {
+  case ASYNC_ACTIVATE:
+    done.beginMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    break;
+  case ASYNC_MOTION:
+    done.beginCalibration();
+    break;
+  case ASYNC_CALIBRATION:
+    Serial.println(done.isCalibrationValid() ? "calibration ok" : "calibration checksum mismatch");
+    break;
+  case ASYNC_SNAPSHOT: {
+    float ambient = done.calcAmbientTemp(snapshot.ambientTemp());
+    Serial.print(ambient);
+    Serial.print("  ");
+    Serial.print(done.calcObjectTemp(snapshot.objectTemp(), ambient));
+    Serial.println("  ");
+    break;
+  }
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  pinMode(ledPin, OUTPUT);
+
+  Wire.begin();
+
+  sensor.onComplete(onComplete);
+  sensor.beginActivate();
+}
+
+void loop() {
+  sensor.poll();
+
+  if (!sensor.isBusy() && sensor.isCalibrationValid() && millis() - lastSample >= 100) {
+    lastSample = millis();
+    sensor.beginSnapshot(snapshot);
+  }
+
+  // Other work keeps running while the sensor is being set up and read
+  if (millis() - lastBlink >= 500) {
+    lastBlink = millis();
+    digitalWrite(ledPin, !digitalRead(ledPin));
+  }
+}
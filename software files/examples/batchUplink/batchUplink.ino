@@ -0,0 +1,58 @@
+#include "caliPile.h"
+#include "caliPileRing.h"
+
+// Collects one sample per 120 ms timer period in the background and sends
+// them in batches of 16 (about 2 s), the way a radio uplink would, straight
+// from the ring without copying.
+//
+// The ring holds 32 samples of sizeof(caliPileSample) bytes: 23 on AVR,
+// 24 with padding on 32-bit cores, so 736 or 768 bytes of RAM.
+const int interruptPin = 4;
+const uint16_t batchSize = 16;
+caliPile sensor(interruptPin);
+caliPileRing<32> ring(sensor);
+
+// Sends one sample as 23 bytes: the timestamp little-endian, then the
+// result registers TPOBJECT..CHIP_STATUS, independent of struct padding
+// and byte order of the core
+void sendSample(const caliPileSample &sample) {
+  uint8_t timestamp[4];
+  for (uint8_t i = 0; i < 4; i++) {
+    timestamp[i] = (sample.timestamp >> (8 * i)) & 0xFF;
+  }
+  Serial.write(timestamp, sizeof(timestamp));
+  Serial.write(sample.snapshot.raw, SNAPSHOT_LENGTH);
+}
+
+void uplink() {
+  const caliPileSample *span;
+  uint16_t count;
+  while ((count = ring.borrow(span)) > 0) {
+    for (uint16_t i = 0; i < count; i++) {
+      sendSample(span[i]);
+    }
+    ring.release(count);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms120);
+  sensor.TempCalculations();
+
+  sensor.setConfig(INT_MASK, 0);
+  sensor.initTimer(120);
+  sensor.interruptStatus();
+}
+
+void loop() {
+  ring.service();
+
+  if (ring.available() >= batchSize) {
+    uplink();
+  }
+}
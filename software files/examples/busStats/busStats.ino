@@ -0,0 +1,72 @@
+#include "caliPile.h"
+
+// Uncomment CALIPILE_BUS_STATS in caliPile.h to build this example.
+#ifndef CALIPILE_BUS_STATS
+#error "Enable CALIPILE_BUS_STATS in caliPile.h"
+#endif
+
+const int interruptPin = 4;
+// SDA and SCL let the bus be freed if the sensor ever holds SDA low
+caliPileWire bus(Wire, SDA, SCL);
+caliPile sensor(interruptPin, bus);
+caliPileSnapshot snapshot;
+
+void printStats(const char *name) {
+  const caliPileBusStats &stats = sensor.busStats();
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(stats.transactions);
+  Serial.print(" transactions, ");
+  Serial.print(stats.bytes);
+  Serial.print(" bytes, ");
+  Serial.print(stats.busMicros);
+  Serial.print(" us, ");
+  Serial.print(stats.nacks);
+  Serial.print(" NACKs, ");
+  Serial.print(stats.busErrors);
+  Serial.print(" bus errors, ");
+  Serial.print(stats.shortReads);
+  Serial.print(" short reads, ");
+  Serial.print(stats.timeouts);
+  Serial.print(" timeouts, ");
+  Serial.print(stats.recoveries);
+  Serial.print(" recoveries, ");
+  Serial.print(stats.maxMicros);
+  Serial.println(" us longest access");
+  sensor.resetBusStats();
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+  Wire.setClock(BUS_CLOCK_HZ);
+  sensor.setBusClock(BUS_CLOCK_HZ);
+  sensor.setBusTimeout(5000);
+
+  sensor.activateSensor();
+  printStats("activateSensor");
+
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+  printStats("initMotion");
+
+  sensor.TempCalculations();
+  printStats("TempCalculations");
+
+  sensor.initTPotThreshHold(131);
+  printStats("initTPotThreshHold");
+}
+
+void loop() {
+  sensor.calcObjectTemp(sensor.getObjectTemp(), sensor.calcAmbientTemp(sensor.getAmbientTemp()));
+  sensor.getPresenceStat();
+  sensor.getMotionStat();
+  sensor.getAmbientShockStat();
+  sensor.interruptStatus();
+  printStats("getters");
+
+  sensor.readSnapshot(snapshot);
+  printStats("readSnapshot");
+
+  delay(1000);
+}
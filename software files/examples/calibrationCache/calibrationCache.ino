@@ -0,0 +1,42 @@
+#include <EEPROM.h>
+#include "caliPile.h"
+
+// Keeps the sensor calibration in the MCU EEPROM so warm boots read only
+// the sensor's EEPROM checksum instead of the whole image. A cache from
+// another sensor fails that check and is replaced. Written for AVR; on ESP
+// boards call EEPROM.begin() and EEPROM.commit() around the accesses.
+const int interruptPin = 4;
+const int cacheAddress = 0;
+caliPile sensor(interruptPin);
+caliPileSnapshot snapshot;
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+
+  caliPileCalibration cal;
+  EEPROM.get(cacheAddress, cal);
+  if (sensor.loadCalibration(cal)) {
+    Serial.println("calibration restored from cache, checksum matches");
+  } else if (sensor.TempCalculations()) {
+    EEPROM.put(cacheAddress, sensor.calibration());
+    Serial.println("calibration read from sensor and cached");
+  } else {
+    Serial.println("sensor EEPROM checksum mismatch");
+  }
+}
+
+void loop() {
+  sensor.readSnapshot(snapshot);
+  float ambient = sensor.calcAmbientTemp(snapshot.ambientTemp());
+
+  Serial.print(ambient);
+  Serial.print("  ");
+  Serial.print(sensor.calcObjectTemp(snapshot.objectTemp(), ambient));
+  Serial.println("  ");
+  delay(100);
+}
@@ -0,0 +1,37 @@
+#include "caliPile.h"
+#include "caliPileCapture.h"
+
+// Streams every conversion cycle as binary records over Serial. Decode the
+// stream on the host with caliPileCaptureReader (src/caliPileCaptureFormat.h).
+const int interruptPin = 4;
+caliPile sensor(interruptPin);
+caliPileCaptureWriter capture(Serial);
+caliPileSnapshot snapshot;
+uint32_t lastSample = 0;
+uint32_t lastHeader = 0;
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+  sensor.TempCalculations();
+
+  capture.begin(sensor);
+}
+
+void loop() {
+  if (millis() - lastSample >= sensor.cycleTimeMs()) {
+    lastSample = millis();
+    sensor.readSnapshot(snapshot);
+    capture.write(lastSample, snapshot);
+  }
+
+  // Repeat the header now and then so a host can attach at any time
+  if (millis() - lastHeader >= 10000) {
+    lastHeader = millis();
+    capture.begin(sensor);
+  }
+}
@@ -0,0 +1,46 @@
+#include "caliPile.h"
+#include "caliPileEmulator.h"
+
+// Runs the filter and detector model next to the sensor with the same
+// configuration and prints both, to check the model against the chip
+// before evaluating settings offline on recorded data. The model steps once
+// per conversion, whatever cycle time initMotion() selects.
+const int interruptPin = 4;
+caliPile sensor(interruptPin);
+caliPileEmulator model;
+caliPileSnapshot snapshot;
+uint32_t lastSample = 0;
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+  sensor.syncConfig();
+
+  for (uint8_t reg = SLP12; reg < SLP12 + CONFIG_LENGTH; reg++) {
+    model.setRegister(reg, sensor.configValue(reg));
+  }
+}
+
+void loop() {
+  if (millis() - lastSample >= EMULATOR_CONVERSION_MS) {
+    lastSample = millis();
+    sensor.readSnapshot(snapshot);
+    const caliPileEmulatorState &state = model.step(snapshot.objectTemp(), snapshot.ambientTemp());
+
+    Serial.print(snapshot.objectTempLP2());
+    Serial.print("  ");
+    Serial.print(state.objectTempLP2);
+    Serial.print("  ");
+    Serial.print(snapshot.presenceStat());
+    Serial.print("  ");
+    Serial.print(state.presenceStat);
+    Serial.print("  ");
+    Serial.print(snapshot.chipStatus() & 0x1F, HEX);
+    Serial.print("  ");
+    Serial.println(state.chipStatus & 0x1F, HEX);
+  }
+}
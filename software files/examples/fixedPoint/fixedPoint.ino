@@ -0,0 +1,77 @@
+#include "caliPile.h"
+#include "caliPileFixedPoint.h"
+
+// Reads temperatures with the integer-only conversion. At startup it times
+// both conversions over -40..+120 C ambient and the 17 bit object range and
+// prints the time per conversion of each. The accuracy against the float
+// path is checked on the host by extras/tests/fixedPointTest.cpp.
+const int interruptPin = 4;
+caliPile sensor(interruptPin);
+caliPileFixedPoint fixedPoint;
+caliPileSnapshot snapshot;
+
+volatile int32_t sink;
+
+void timeConversions() {
+  uint32_t points = 0;
+  uint32_t fixedTime = 0;
+  uint32_t floatTime = 0;
+
+  for (int32_t celsius = -40; celsius <= 120; celsius += 10) {
+    int32_t raw = sensor.PTAT25 + (celsius - 25) * (int32_t) sensor.M;
+    if (raw < 0 || raw > 0x7FFF) {
+      continue;
+    }
+    uint16_t ambientRaw = raw;
+    float ambient = sensor.calcAmbientTemp(ambientRaw);
+    for (uint32_t objectRaw = 0; objectRaw < 0x20000; objectRaw += 1024) {
+      uint32_t start = micros();
+      float reference = sensor.calcObjectTemp(objectRaw, ambient);
+      floatTime += micros() - start;
+      start = micros();
+      sink = fixedPoint.objectTemp(objectRaw, ambientRaw);
+      fixedTime += micros() - start;
+      sink += (int32_t) reference;
+      points++;
+    }
+  }
+
+  Serial.print(points);
+  Serial.println(" points");
+  Serial.print("fixed point: ");
+  Serial.print((float) fixedTime / points);
+  Serial.println(" us/conversion");
+  Serial.print("float:       ");
+  Serial.print((float) floatTime / points);
+  Serial.println(" us/conversion");
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+  sensor.TempCalculations();
+  fixedPoint.build(sensor);
+
+  timeConversions();
+}
+
+void loop() {
+  sensor.readSnapshot(snapshot);
+  int32_t ambient = fixedPoint.ambientTemp(snapshot.ambientTemp());
+  int32_t object = fixedPoint.objectTemp(snapshot.objectTemp(), snapshot.ambientTemp());
+
+  Serial.print(ambient / 100);
+  Serial.print('.');
+  Serial.print(ambient % 100 / 10);
+  Serial.print(ambient % 10);
+  Serial.print("  ");
+  Serial.print(object / 100);
+  Serial.print('.');
+  Serial.print(object % 100 / 10);
+  Serial.println(object % 10);
+  delay(100);
+}
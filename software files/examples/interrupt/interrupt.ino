@@ -1,12 +1,38 @@
 #include "caliPile.h"
+#include "caliPileEvents.h"
 
 #define interruptPin 16
 uint8_t  intStatus = 0;
 bool presSign = false, motSign = false;
 caliPile sensor(interruptPin);
+caliPileEventQueue events(sensor);
 
 void inthandler() {
-  newInt = true;
+  events.onInterrupt();
+}
+
+void onEvent(const caliPileEvent &event) {
+  Serial.print(event.timestamp);
+  Serial.print("  ");
+  if (event.isPresence()) {
+    Serial.print("presence ");
+    Serial.print(event.presence);
+    Serial.print("  ");
+  }
+  if (event.isMotion()) {
+    Serial.print("motion ");
+    Serial.print(event.motion);
+    Serial.print("  ");
+  }
+  if (event.isAmbientShock()) {
+    Serial.print("shock ");
+    Serial.print(event.ambientShock);
+    Serial.print("  ");
+  }
+  if (event.isOverTemp()) {
+    Serial.print("over temperature");
+  }
+  Serial.println();
 }
 
 void setup() {
@@ -24,28 +50,11 @@ void setup() {
   sensor.initTpMotionThreshHold(2);
 
   sensor.initTpPresenceThreshHold(2);
+  sensor.interruptStatus();  // release INT so the next event produces a falling edge
   attachInterrupt(digitalPinToInterrupt(interruptPin), inthandler, FALLING);  // define interrupt for INT pin output of CaliPile
 }
 
 void loop() {
-
-  uint8_t presence = sensor.readRegister(SENSOR_ADDRESS, TPPRESENCE);
-  uint8_t motion = sensor.readRegister(SENSOR_ADDRESS, TPMOTION);
-  uint8_t ambshock = sensor.readRegister(SENSOR_ADDRESS, TPAMB_SHOCK);
-
-  /*if(interruptPin == 0) {
-    Serial.println(sensor.readRegister(SENSOR_ADDRESS, INTERRUPT_STATUS));
-  } */
-
-  Serial.print(presence);
-  Serial.print("  ");
-  Serial.print(motion);
-  Serial.print("  ");
-  Serial.println(ambshock);
-
-  /*Serial.print(sensor.calcAmbientTemp(sensor.getAmbientTemp()));
-  Serial.print("  ");
-  Serial.print(sensor.calcObjectTemp(sensor.getObjectTemp(), sensor.calcAmbientTemp(sensor.getAmbientTemp())));
-  Serial.println("  ");*/
-  delay(100);
+  // Reads the sensor only when the INT pin has fired
+  events.service(onEvent);
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "caliPile.h"
+
+// Uncomment CALIPILE_METHOD_STATS in caliPile.h to build this example.
+#ifndef CALIPILE_METHOD_STATS
+#error "Enable CALIPILE_METHOD_STATS in caliPile.h"
+#endif
+
+// Runs a typical read loop and prints every 10 s where its time went.
+const int interruptPin = 4;
+caliPile sensor(interruptPin);
+uint32_t lastReport = 0;
+
+void report() {
+  const caliPileMethodStats *stats = sensor.methodStats();
+  for (uint8_t i = 0; i < STAT_METHODS; i++) {
+    if (stats[i].calls == 0) {
+      continue;
+    }
+    Serial.print(caliPile::methodName(i));
+    Serial.print(": ");
+    Serial.print(stats[i].calls);
+    Serial.print(" calls, ");
+    Serial.print(stats[i].totalMicros / stats[i].calls);
+    Serial.print(" us avg, ");
+    Serial.print(stats[i].maxMicros);
+    Serial.println(" us max");
+  }
+  Serial.println();
+  sensor.resetMethodStats();
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+  sensor.TempCalculations();
+  report();
+}
+
+void loop() {
+  float ambient = sensor.calcAmbientTemp(sensor.getAmbientTemp());
+  sensor.calcObjectTemp(sensor.getObjectTemp(), ambient);
+  sensor.getPresenceStat();
+  sensor.getMotionStat();
+  delay(30);
+
+  if (millis() - lastReport >= 10000) {
+    lastReport = millis();
+    report();
+  }
+}
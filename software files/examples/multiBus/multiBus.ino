@@ -0,0 +1,46 @@
+#include "caliPile.h"
+
+// Two sensors on two I2C buses (needs a board with Wire1, e.g. ESP32).
+// A third one sits on the first bus with A0 pulled high (address 0x0D).
+const int interruptPinA = 4;
+const int interruptPinB = 5;
+const int interruptPinC = 6;
+
+caliPileWire busA(Wire);
+caliPileWire busB(Wire1);
+
+caliPile sensorA(interruptPinA, busA);
+caliPile sensorB(interruptPinB, busB);
+caliPile sensorC(interruptPinC, busA, SENSOR_ADDRESS + 1);
+
+caliPile *sensors[] = {&sensorA, &sensorB, &sensorC};
+caliPileSnapshot snapshot;
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+  Wire1.begin();
+
+  for (caliPile *sensor : sensors) {
+    sensor->activateSensor();
+    sensor->initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    sensor->TempCalculations();
+  }
+}
+
+void loop() {
+  for (caliPile *sensor : sensors) {
+    sensor->readSnapshot(snapshot);
+    float ambient = sensor->calcAmbientTemp(snapshot.ambientTemp());
+
+    Serial.print(sensor->address(), HEX);
+    Serial.print(": ");
+    Serial.print(ambient);
+    Serial.print("  ");
+    Serial.print(sensor->calcObjectTemp(snapshot.objectTemp(), ambient));
+    Serial.print("  ");
+  }
+  Serial.println();
+  delay(100);
+}
@@ -0,0 +1,49 @@
+#include "caliPile.h"
+#include "caliPileArray.h"
+
+// Four sensors on one bus, A1/A0 strapped to 00, 01, 10 and 11.
+const int interruptPin = 4;
+
+caliPileWire bus(Wire);
+caliPile sensor0(interruptPin, bus, SENSOR_ADDRESS);
+caliPile sensor1(interruptPin, bus, SENSOR_ADDRESS + 1);
+caliPile sensor2(interruptPin, bus, SENSOR_ADDRESS + 2);
+caliPile sensor3(interruptPin, bus, SENSOR_ADDRESS + 3);
+caliPileArray sensors;
+
+void onSample(uint8_t index, caliPile &sensor, const caliPileSnapshot &snapshot) {
+  float ambient = sensor.calcAmbientTemp(snapshot.ambientTemp());
+
+  Serial.print(index);
+  Serial.print("  ");
+  Serial.print(sensor.calcObjectTemp(snapshot.objectTemp(), ambient));
+  Serial.print("  ");
+  Serial.print(snapshot.presenceStat());
+  Serial.print("  ");
+  Serial.println(snapshot.motionStat());
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensors.add(sensor0);
+  sensors.add(sensor1);
+  sensors.add(sensor2);
+  sensors.add(sensor3);
+
+  Serial.print(sensors.provision());
+  Serial.println(" sensors online");
+
+  for (uint8_t i = 0; i < sensors.size(); i++) {
+    if (sensors.isOnline(i)) {
+      sensors.sensor(i).initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+      sensors.sensor(i).TempCalculations();
+    }
+  }
+}
+
+void loop() {
+  sensors.service(onSample);
+}
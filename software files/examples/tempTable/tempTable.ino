@@ -0,0 +1,72 @@
+#include "caliPile.h"
+#include "caliPileTempTable.h"
+
+// Compares calcObjectTemp() with the lookup table on this board and
+// prints the time per conversion and the largest difference seen.
+const int interruptPin = 4;
+const uint16_t conversions = 200;
+caliPile sensor(interruptPin);
+caliPileTempTable table;
+caliPileSnapshot snapshot;
+
+volatile float sink;
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+  sensor.TempCalculations();
+  table.build(sensor);
+
+  sensor.readSnapshot(snapshot);
+  uint32_t object = snapshot.objectTemp();
+  float ambient = sensor.calcAmbientTemp(snapshot.ambientTemp());
+
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < conversions; i++) {
+    sink = sensor.calcObjectTemp(object + i, ambient);
+  }
+  uint32_t exactTime = micros() - start;
+
+  start = micros();
+  for (uint16_t i = 0; i < conversions; i++) {
+    sink = table.objectTemp(object + i, ambient);
+  }
+  uint32_t tableTime = micros() - start;
+
+  float maxError = 0;
+  for (uint16_t i = 0; i < conversions; i++) {
+    float error = fabs(sensor.calcObjectTemp(object + i, ambient) - table.objectTemp(object + i, ambient));
+    if (error > maxError) {
+      maxError = error;
+    }
+  }
+
+  Serial.print("calcObjectTemp: ");
+  Serial.print((float) exactTime / conversions);
+  Serial.print(" us/conversion, ");
+  Serial.print(F_CPU / 1000000.0f * exactTime / conversions);
+  Serial.println(" cycles");
+  Serial.print("table:          ");
+  Serial.print((float) tableTime / conversions);
+  Serial.print(" us/conversion, ");
+  Serial.print(F_CPU / 1000000.0f * tableTime / conversions);
+  Serial.println(" cycles");
+  Serial.print("max error:      ");
+  Serial.print(maxError, 4);
+  Serial.println(" K");
+}
+
+void loop() {
+  sensor.readSnapshot(snapshot);
+  float ambient = table.ambientTemp(snapshot.ambientTemp());
+
+  Serial.print(ambient);
+  Serial.print("  ");
+  Serial.print(table.objectTemp(snapshot.objectTemp(), ambient));
+  Serial.println("  ");
+  delay(100);
+}
@@ -0,0 +1,34 @@
+#include "caliPile.h"
+
+// Reads one sample every 120 ms, paced by the sensor's own timer interrupt
+// instead of delay(), so every conversion cycle is read exactly once.
+const int interruptPin = 4;
+caliPile sensor(interruptPin);
+caliPileSnapshot snapshot;
+
+void setup() {
+  Serial.begin(115200);
+
+  Wire.begin();
+
+  sensor.activateSensor();
+  sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms120);
+  sensor.TempCalculations();
+
+  // Only the timer may pull INT low, other events would add extra reads
+  sensor.setConfig(INT_MASK, 0);
+  sensor.initTimer(120);
+  sensor.interruptStatus();
+}
+
+void loop() {
+  if (sensor.readTimedSnapshot(snapshot) & INT_TIMER) {
+    float ambient = sensor.calcAmbientTemp(snapshot.ambientTemp());
+
+    Serial.print(millis());
+    Serial.print("  ");
+    Serial.print(ambient);
+    Serial.print("  ");
+    Serial.println(sensor.calcObjectTemp(snapshot.objectTemp(), ambient));
+  }
+}
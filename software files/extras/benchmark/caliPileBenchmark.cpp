@@ -0,0 +1,262 @@
+// Times the decode and temperature kernels of the library on a Linux host
+// and checks their results against golden values.
+//
+//   caliPileBenchmark [milliseconds]
+//
+// Every kernel runs over the same 16 result-register snapshots, scenes from
+// a 0 C room looking at ice to a 50 C enclosure looking at a 120 C part,
+// with the calibration of the sensor emulated by caliPileFakeI2C. The
+// argument sets the minimum time per kernel (default 200). Prints ns/op and
+// ops/s per kernel; exits with 1 if any result is off its golden value, so
+// a change that speeds up a kernel but alters its output is caught.
+//
+// Build from this directory, with the optimization level to be measured:
+//
+//   g++ -std=c++11 -O2 -pthread -I../../src -o caliPileBenchmark caliPileBenchmark.cpp ../../src/*.cpp
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "caliPile.h"
+#include "caliPileLinuxI2C.h"
+#include "caliPileFakeI2C.h"
+#include "caliPileTempTable.h"
+#include "caliPileFixedPoint.h"
+#include "caliPileBatch.h"
+#include "caliPileGolden.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPileTempTable table;
+caliPileFixedPoint fixedPoint;
+
+uint32_t objectRaw[SCENES];
+uint16_t ambientRaw[SCENES];
+float ambientK[SCENES];
+float objectK[SCENES];
+float batchAmbient[SCENES];
+float batchObject[SCENES];
+
+// Results are summed into these so the compiler cannot drop the kernels
+volatile uint32_t integerSink;
+volatile float floatSink;
+
+void decodeObject(uint32_t passes) {
+    uint32_t sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += scenes[i].objectTemp();
+        }
+    }
+    integerSink = sum;
+}
+
+void decodeAmbient(uint32_t passes) {
+    uint32_t sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += scenes[i].ambientTemp();
+        }
+    }
+    integerSink = sum;
+}
+
+void decodeObjectLP1(uint32_t passes) {
+    uint32_t sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += scenes[i].objectTempLP1();
+        }
+    }
+    integerSink = sum;
+}
+
+void decodeObjectLP2(uint32_t passes) {
+    uint32_t sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += scenes[i].objectTempLP2();
+        }
+    }
+    integerSink = sum;
+}
+
+void decodeObjectLP2Frozen(uint32_t passes) {
+    uint32_t sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += scenes[i].objectTempLP2Frozen();
+        }
+    }
+    integerSink = sum;
+}
+
+void ambientFloat(uint32_t passes) {
+    float sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += sensor.calcAmbientTemp(ambientRaw[i]);
+        }
+    }
+    floatSink = sum;
+}
+
+void objectFloat(uint32_t passes) {
+    float sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += sensor.calcObjectTemp(objectRaw[i], ambientK[i]);
+        }
+    }
+    floatSink = sum;
+}
+
+void objectVariant(uint32_t passes) {
+    float sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += sensor.calcObjectTemp<caliPileTPiS1S>(objectRaw[i], ambientK[i]);
+        }
+    }
+    floatSink = sum;
+}
+
+void objectTable(uint32_t passes) {
+    float sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += table.objectTemp(objectRaw[i], ambientK[i]);
+        }
+    }
+    floatSink = sum;
+}
+
+void objectFixedPoint(uint32_t passes) {
+    uint32_t sum = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        for (uint8_t i = 0; i < SCENES; i++) {
+            sum += fixedPoint.objectTemp(objectRaw[i], ambientRaw[i]);
+        }
+    }
+    integerSink = sum;
+}
+
+void convertBatch(uint32_t passes) {
+    caliPileCalibration cal = sensor.calibration();
+    for (uint32_t p = 0; p < passes; p++) {
+        caliPileConvertBatch(cal, sensor.exponent(), objectRaw, ambientRaw, batchObject, batchAmbient, SCENES);
+    }
+    floatSink = batchObject[0];
+}
+
+// One EEPROM image read and decoded per pass, through the emulated bus
+void tempCalculations(uint32_t passes) {
+    uint32_t valid = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        valid += sensor.TempCalculations();
+    }
+    integerSink = valid;
+}
+
+struct benchmark {
+    const char *name;
+    void (*run)(uint32_t passes);
+    uint8_t opsPerPass;
+};
+
+const benchmark benchmarks[] = {
+    {"objectTemp decode", decodeObject, SCENES},
+    {"ambientTemp decode", decodeAmbient, SCENES},
+    {"objectTempLP1 decode", decodeObjectLP1, SCENES},
+    {"objectTempLP2 decode", decodeObjectLP2, SCENES},
+    {"objectTempLP2Frozen decode", decodeObjectLP2Frozen, SCENES},
+    {"calcAmbientTemp", ambientFloat, SCENES},
+    {"calcObjectTemp", objectFloat, SCENES},
+    {"calcObjectTemp<TPiS1S>", objectVariant, SCENES},
+    {"caliPileTempTable", objectTable, SCENES},
+    {"caliPileFixedPoint", objectFixedPoint, SCENES},
+    {"caliPileConvertBatch", convertBatch, SCENES},
+    {"TempCalculations (fake bus)", tempCalculations, 1}
+};
+
+uint16_t failures = 0;
+
+void checkInteger(const char *kernel, uint8_t scene, uint32_t value, uint32_t golden) {
+    if (value != golden) {
+        printf("FAIL %s scene %u: %u, expected %u\n", kernel, scene, value, golden);
+        failures++;
+    }
+}
+
+void checkFloat(const char *kernel, uint8_t scene, float value, float golden, float tolerance) {
+    if (!(fabsf(value - golden) <= tolerance)) {
+        printf("FAIL %s scene %u: %.4f, expected %.4f\n", kernel, scene, value, golden);
+        failures++;
+    }
+}
+
+// Runs every kernel once over the scenes and compares with the golden values
+void checkGolden() {
+    if (!(fabsf(sensor.calibration().k - expectedK) <= expectedK * 1e-5f)) {
+        printf("FAIL TempCalculations: k %g, expected %g\n", sensor.calibration().k, expectedK);
+        failures++;
+    }
+    caliPileConvertBatch(sensor.calibration(), sensor.exponent(), objectRaw, ambientRaw, batchObject, batchAmbient, SCENES);
+    for (uint8_t i = 0; i < SCENES; i++) {
+        checkInteger("objectTemp", i, scenes[i].objectTemp(), expected[i].object);
+        checkInteger("ambientTemp", i, scenes[i].ambientTemp(), expected[i].ambient);
+        checkInteger("objectTempLP1", i, scenes[i].objectTempLP1(), expected[i].objectLP1);
+        checkInteger("objectTempLP2", i, scenes[i].objectTempLP2(), expected[i].objectLP2);
+        checkInteger("ambientTempLP3", i, scenes[i].ambientTempLP3(), expected[i].ambientLP3);
+        checkInteger("objectTempLP2Frozen", i, scenes[i].objectTempLP2Frozen(), expected[i].objectLP2Frozen);
+        checkFloat("calcAmbientTemp", i, sensor.calcAmbientTemp(ambientRaw[i]), expected[i].ambientK, floatTolerance);
+        checkFloat("calcObjectTemp", i, sensor.calcObjectTemp(objectRaw[i], ambientK[i]), expected[i].objectK, floatTolerance);
+        checkFloat("calcObjectTemp<TPiS1S>", i, sensor.calcObjectTemp<caliPileTPiS1S>(objectRaw[i], ambientK[i]), expected[i].objectK, floatTolerance);
+        checkFloat("caliPileTempTable", i, table.objectTemp(objectRaw[i], ambientK[i]), expected[i].objectK, tableTolerance);
+        checkFloat("caliPileFixedPoint", i, fixedPoint.objectTemp(objectRaw[i], ambientRaw[i]) / 100.0f, expected[i].objectK, fixedTolerance);
+        checkFloat("caliPileConvertBatch", i, batchObject[i], expected[i].objectK, batchTolerance);
+    }
+}
+
+// Doubles the passes until one run lasts minimumMs, then reports the rate
+void measure(const benchmark &b, uint32_t minimumMs) {
+    uint32_t passes = 1;
+    double elapsed;
+    for (;;) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        b.run(passes);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed * 1000 >= minimumMs || passes >= 0x80000000UL) {
+            break;
+        }
+        passes *= 2;
+    }
+    double ops = (double) passes * b.opsPerPass;
+    printf("%-28s %10.2f ns/op %14.0f ops/s\n", b.name, elapsed * 1e9 / ops, ops / elapsed);
+}
+
+int main(int argc, char **argv) {
+    uint32_t minimumMs = argc > 1 ? strtoul(argv[1], 0, 0) : 200;
+
+    fake.addSensor(SENSOR_ADDRESS);
+    if (!sensor.TempCalculations()) {
+        printf("FAIL TempCalculations: EEPROM checksum mismatch\n");
+        return 1;
+    }
+    table.build(sensor);
+    fixedPoint.build(sensor);
+    for (uint8_t i = 0; i < SCENES; i++) {
+        objectRaw[i] = scenes[i].objectTemp();
+        ambientRaw[i] = scenes[i].ambientTemp();
+        ambientK[i] = sensor.calcAmbientTemp(ambientRaw[i]);
+    }
+
+    checkGolden();
+    printf("golden values: %s\n\n", failures == 0 ? "ok" : "MISMATCH");
+
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        measure(benchmarks[i], minimumMs);
+    }
+    return failures == 0 ? 0 : 1;
+}
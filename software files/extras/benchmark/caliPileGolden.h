@@ -0,0 +1,75 @@
+#ifndef caliPileGolden_h
+#define caliPileGolden_h
+
+/*
+ * Result-register snapshots and their golden values, shared by the
+ * benchmark and the host tests. The calibration is that of the sensor
+ * emulated by caliPileFakeI2C.
+ */
+
+#include "caliPile.h"
+
+#define SCENES 16
+
+// TPOBJECT..CHIP_STATUS as read from the sensor
+const caliPileSnapshot scenes[SCENES] = {
+    {{0x40, 0x24, 0x1A, 0x2C, 0x40, 0x23, 0x84, 0x02, 0x20, 0x34, 0x58, 0x40, 0x1A, 0x00, 0x14, 0x00, 0x00, 0x08, 0x08}},
+    {{0x4B, 0x56, 0x9D, 0x88, 0x4B, 0x55, 0x84, 0xB5, 0x30, 0x3B, 0x0E, 0x4B, 0x4D, 0x00, 0x13, 0x07, 0x01, 0x08, 0x08}},
+    {{0x42, 0x58, 0x20, 0xE4, 0x42, 0x56, 0x84, 0x25, 0x30, 0x41, 0xC4, 0x42, 0x4F, 0x00, 0x12, 0x0E, 0x02, 0x08, 0x08}},
+    {{0x44, 0x4B, 0xA4, 0x40, 0x44, 0x49, 0x84, 0x44, 0x50, 0x48, 0x80, 0x44, 0x43, 0x00, 0x11, 0x15, 0x00, 0x08, 0x08}},
+    {{0x47, 0x22, 0xA6, 0x44, 0x47, 0x20, 0x04, 0x72, 0x08, 0x4C, 0x86, 0x47, 0x1A, 0x80, 0x10, 0x1C, 0x01, 0x08, 0x08}},
+    {{0x42, 0x58, 0x27, 0x9C, 0x42, 0x57, 0x84, 0x25, 0x48, 0x4F, 0x34, 0x42, 0x50, 0x80, 0x0F, 0x23, 0x02, 0x08, 0x08}},
+    {{0x47, 0x45, 0xA8, 0x48, 0x47, 0x44, 0x84, 0x74, 0x08, 0x50, 0x90, 0x47, 0x3E, 0x80, 0x0E, 0x02, 0x00, 0x08, 0x08}},
+    {{0x43, 0x38, 0xA8, 0xF4, 0x43, 0x37, 0x04, 0x33, 0x20, 0x51, 0xE6, 0x43, 0x32, 0x00, 0x0D, 0x09, 0x01, 0x08, 0x08}},
+    {{0x4F, 0x23, 0xA9, 0xA0, 0x4F, 0x21, 0x84, 0xF2, 0x18, 0x53, 0x3C, 0x4F, 0x1D, 0x80, 0x0C, 0x10, 0x02, 0x08, 0x08}},
+    {{0x42, 0x58, 0x2A, 0xF8, 0x42, 0x55, 0x84, 0x25, 0x48, 0x55, 0xF0, 0x42, 0x52, 0x80, 0x0B, 0x17, 0x00, 0x08, 0x08}},
+    {{0x43, 0xE0, 0x2B, 0xA4, 0x43, 0xDF, 0x84, 0x3D, 0xB0, 0x57, 0x46, 0x43, 0xDB, 0x00, 0x0A, 0x1E, 0x01, 0x08, 0x08}},
+    {{0x58, 0xE0, 0x2C, 0xFC, 0x58, 0xDF, 0x05, 0x8D, 0x98, 0x59, 0xF4, 0x58, 0xDB, 0x80, 0x09, 0x25, 0x02, 0x08, 0x08}},
+    {{0x3E, 0xD1, 0xAE, 0x54, 0x3E, 0xD0, 0x03, 0xEC, 0xF8, 0x5C, 0xA8, 0x3E, 0xCD, 0x80, 0x08, 0x04, 0x00, 0x08, 0x08}},
+    {{0x44, 0x02, 0x31, 0xB0, 0x44, 0x00, 0x04, 0x3F, 0xE8, 0x63, 0x5E, 0x43, 0xFE, 0x80, 0x07, 0x0B, 0x01, 0x08, 0x08}},
+    {{0x5C, 0xE2, 0xB5, 0x0C, 0x5C, 0xE0, 0x05, 0xCD, 0xD8, 0x6A, 0x14, 0x5C, 0xDF, 0x80, 0x06, 0x12, 0x02, 0x08, 0x08}},
+    {{0x65, 0x4E, 0x3B, 0xC4, 0x65, 0x4D, 0x86, 0x54, 0x78, 0x77, 0x88, 0x65, 0x4B, 0x80, 0x05, 0x19, 0x00, 0x00, 0x00}}
+};
+
+/*
+ * Decoded fields and temperatures of each scene in degrees Kelvin, from a
+ * double precision evaluation of the datasheet formulas.
+ */
+struct golden {
+    uint32_t object;
+    uint16_t ambient;
+    uint32_t objectLP1, objectLP2;
+    uint16_t ambientLP3;
+    uint32_t objectLP2Frozen;
+    float ambientK, objectK;
+};
+
+const golden expected[SCENES] = {
+    {32840, 6700, 32839, 32836, 6700, 32820, 273.1500f, 263.1546f},
+    {38573, 7560, 38571, 38566, 7559, 38554, 278.1500f, 309.6500f},
+    {33968, 8420, 33965, 33958, 8418, 33950, 283.1500f, 283.1500f},
+    {34967, 9280, 34963, 34954, 9280, 34950, 288.1500f, 295.1482f},
+    {36421, 9796, 36416, 36417, 9795, 36405, 291.1500f, 307.1470f},
+    {33968, 10140, 33967, 33961, 10138, 33953, 293.1500f, 293.1500f},
+    {36491, 10312, 36489, 36481, 10312, 36477, 294.1500f, 310.1501f},
+    {34417, 10484, 34414, 34404, 10483, 34404, 295.1500f, 298.1494f},
+    {40519, 10656, 40515, 40515, 10654, 40507, 296.1500f, 333.1511f},
+    {33968, 11000, 33963, 33961, 11000, 33957, 298.1500f, 298.1500f},
+    {34752, 11172, 34751, 34742, 11171, 34742, 299.1500f, 304.1477f},
+    {45504, 11516, 45502, 45491, 11514, 45495, 301.1500f, 358.1499f},
+    {32163, 11860, 32160, 32159, 11860, 32155, 303.1500f, 291.1529f},
+    {34820, 12720, 34816, 34813, 12719, 34813, 308.1500f, 313.1519f},
+    {47557, 13580, 47552, 47547, 13578, 47551, 313.1500f, 373.1486f},
+    {51868, 15300, 51867, 51855, 15300, 51863, 323.1500f, 393.1486f}
+};
+
+// k of the emulated EEPROM: (UOUT1 - U0) / (373.15^3.8 - 298.15^3.8)
+const float expectedK = 4.711192e-6f;
+
+// Allowed differences to the golden temperatures, in degrees Kelvin
+const float floatTolerance = 0.01f;
+const float batchTolerance = 0.01f;
+const float tableTolerance = 0.05f;
+const float fixedTolerance = 0.02f;
+
+#endif
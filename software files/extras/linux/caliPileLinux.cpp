@@ -0,0 +1,106 @@
+// Reads CaliPile sensors from a Linux host (Raspberry Pi, BeagleBone, any
+// board with an i2c-dev node), one worker thread per sensor. The workers
+// share one transport, and the general call reload that wakes the sensors
+// is sent once before they start.
+//
+//   caliPileLinux [--fake] [device] [address...]
+//
+// device defaults to /dev/i2c-1 and the address list to 0x0C. With --fake
+// the sensors are emulated by caliPileFakeI2C and no hardware is needed;
+// the emulated bus is held once half way through to show the recovery.
+//
+// Build from this directory:
+//
+//   g++ -std=c++11 -O2 -pthread -I../../src -o caliPileLinux caliPileLinux.cpp ../../src/*.cpp
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "caliPile.h"
+#include "caliPileLinuxI2C.h"
+#include "caliPileFakeI2C.h"
+
+const unsigned samples = 20;
+const unsigned long samplePeriodMs = 100;
+
+const char *devicePath = "/dev/i2c-1";
+caliPileFakeI2C *fake = 0;
+std::mutex output;
+
+// Each worker owns its sensor; the bus and printing are shared
+void worker(caliPileLinuxI2C *bus, uint8_t address) {
+    caliPile sensor(0, *bus, address);
+    sensor.setBusTimeout(20000);
+    sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    if (!sensor.TempCalculations()) {
+        std::lock_guard<std::mutex> guard(output);
+        printf("0x%02X: no sensor or EEPROM checksum mismatch\n", address);
+        return;
+    }
+
+    caliPileSnapshot snapshot;
+    for (unsigned i = 0; i < samples; i++) {
+        uint8_t error = sensor.readSnapshot(snapshot);
+        float ambient = sensor.calcAmbientTemp(snapshot.ambientTemp());
+        float object = sensor.calcObjectTemp(snapshot.objectTemp(), ambient);
+        {
+            std::lock_guard<std::mutex> guard(output);
+            if (error != BUS_OK) {
+                printf("0x%02X: bus error %u, recovered\n", address, error);
+            } else {
+                printf("0x%02X: %.2f  %.2f  %d  %d\n", address, ambient, object, snapshot.presenceStat(), snapshot.motionStat());
+            }
+        }
+        delay(samplePeriodMs);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<uint8_t> addresses;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--fake") == 0) {
+            fake = new caliPileFakeI2C();
+        } else if (strncmp(argv[i], "/dev/", 5) == 0) {
+            devicePath = argv[i];
+        } else {
+            addresses.push_back((uint8_t) strtoul(argv[i], 0, 0));
+        }
+    }
+    if (addresses.empty()) {
+        addresses.push_back(SENSOR_ADDRESS);
+    }
+
+    if (fake != 0) {
+        for (size_t i = 0; i < addresses.size(); i++) {
+            fake->addSensor(addresses[i]);
+            // About 22 °C ambient, the object a little warmer on each sensor
+            fake->setSample(addresses[i], 34500 + 300 * i, 10484);
+        }
+    }
+
+    // One transport per adapter; it serializes the workers' transfers
+    caliPileLinuxI2C bus(devicePath, fake != 0 ? caliPileFakeI2C::calls() : caliPileLinuxI2C::systemCalls());
+    if (!bus.begin()) {
+        perror(devicePath);
+        delete fake;
+        return 1;
+    }
+    // The general call reloads every sensor on the bus, so it goes out once
+    caliPile(0, bus, addresses[0]).activateSensor();
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < addresses.size(); i++) {
+        workers.push_back(std::thread(worker, &bus, addresses[i]));
+    }
+    if (fake != 0) {
+        delay(samples * samplePeriodMs / 2);
+        fake->setStuck(true);
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    delete fake;
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Checks that caliPileArray hands on a result only once the sensor's own
+// timer period ended, whatever the host clock says. The clock is held, so
+// the fake's timer and the array's probes line up the same on every run.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o arrayTest arrayTest.cpp ../../src/*.cpp && ./arrayTest
+#include "caliPileTest.h"
+#include "caliPileArray.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPileArray sensors;
+
+uint8_t received = 0;
+unsigned sampleCount = 0;
+
+void onSample(uint8_t, caliPile &, const caliPileSnapshot &snapshot) {
+    received = snapshot.interruptStatus();
+    sampleCount++;
+}
+
+// Advances the clock until the sensor is due and services it once
+int8_t serviceWhenDue() {
+    delay(sensors.millisUntilDue());
+    return sensors.service(onSample);
+}
+
+// Runs until count samples were delivered; returns the early reads
+unsigned runSamples(unsigned count) {
+    unsigned early = 0;
+    unsigned target = sampleCount + count;
+    // A sensor that stopped delivering ends the run instead of hanging it
+    for (unsigned i = 0; i < 20 * count && sampleCount < target; i++) {
+        if (serviceWhenDue() < 0) {
+            early++;
+        }
+    }
+    CHECK_EQUAL(sampleCount, target);
+    return early;
+}
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    CHECK(sensors.add(sensor));
+    // SLAVE_ADDRESS is only readable with EEPROM access enabled
+    CHECK_EQUAL(sensors.provision(), 1);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, EEPROM_CONTROL), 0);
+    holdClock(true);
+
+    // The first due call programs the on-chip timer to the cycle time
+    fake.resetLog();
+    CHECK_EQUAL(serviceWhenDue(), -1);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TMR_INT), 0);
+    CHECK(fake.getRegister(SENSOR_ADDRESS, INT_MASK) & INT_TIMER);
+    CHECK_EQUAL(sampleCount, 0);
+
+    // A slow oscillator ends the period after 33 ms: the read at 30 ms is
+    // not a sample, and the flags it cleared are passed on with the next one
+    fake.setOscillator(SENSOR_ADDRESS, 90);
+    fake.raiseInterrupt(SENSOR_ADDRESS, INT_PRESENCE);
+    CHECK_EQUAL(sensors.millisUntilDue(), 30);
+    fake.resetLog();
+    CHECK_EQUAL(serviceWhenDue(), -1);
+    CHECK_EQUAL(fake.transactions(), 1);
+    CHECK_EQUAL(sampleCount, 0);
+    CHECK(sensors.millisUntilDue() > 0);
+    CHECK(runSamples(1) <= 2);
+    CHECK_EQUAL(received, INT_TIMER | INT_PRESENCE);
+
+    // Settled, every timer period gives one sample, with about one early
+    // read in 16
+    runSamples(50);
+    unsigned long start = millis();
+    unsigned first = sampleCount;
+    unsigned early = runSamples(160);
+    CHECK((millis() - start) / 33 <= sampleCount - first + 1);
+    CHECK(early <= 160 / 8);
+    CHECK(sensors.millisUntilDue() <= 30 * ARRAY_INTERVAL_MAX_EIGHTHS / 8);
+
+    // A fast oscillator ends the period after 26 ms and is followed as well
+    fake.setOscillator(SENSOR_ADDRESS, 115);
+    runSamples(100);
+    start = millis();
+    first = sampleCount;
+    early = runSamples(160);
+    CHECK((millis() - start) / 26 <= sampleCount - first + 1);
+    CHECK(early <= 160 / 8);
+
+    // A reload noted on the bus is undone by the restore on the next read
+    bus.noteReload();
+    fake.setRegister(SENSOR_ADDRESS, INT_MASK, 0);
+    delay(RELOAD_MS);
+    runSamples(1);
+    CHECK(fake.getRegister(SENSOR_ADDRESS, INT_MASK) & INT_TIMER);
+
+    // A sensor that lost its timer unnoticed, e.g. to a brown-out, is early
+    // until the longest interval; then the timer is programmed again
+    fake.setRegister(SENSOR_ADDRESS, INT_MASK, 0);
+    first = sampleCount;
+    for (int i = 0; i < 20 && !(fake.getRegister(SENSOR_ADDRESS, INT_MASK) & INT_TIMER); i++) {
+        serviceWhenDue();
+    }
+    CHECK(fake.getRegister(SENSOR_ADDRESS, INT_MASK) & INT_TIMER);
+    CHECK_EQUAL(sampleCount, first);
+    CHECK_EQUAL(runSamples(1), 0);
+
+    return testResult("arrayTest");
+}
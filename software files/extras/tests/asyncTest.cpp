@@ -0,0 +1,36 @@
+// Runs the non-blocking state machine faster than any MCU would: the
+// reload wait of beginActivate() takes thousands of poll() calls here.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o asyncTest asyncTest.cpp ../../src/*.cpp && ./asyncTest
+#include "caliPileTest.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+
+    // More than 255 polls inside the 10 ms wait must not resend the general call
+    fake.resetLog();
+    CHECK(sensor.beginActivate());
+    unsigned long start = millis();
+    uint32_t polls = 0;
+    uint8_t result;
+    do {
+        result = sensor.poll();
+        polls++;
+    } while (result == ASYNC_BUSY && millis() - start < 100);
+    CHECK_EQUAL(result, ASYNC_DONE);
+    CHECK(polls > 256);
+    CHECK_EQUAL(fake.transactions(), 1);
+    CHECK(millis() - start >= 10);
+
+    // Each following operation starts from step 0 again
+    fake.resetLog();
+    CHECK(sensor.TempCalculations());
+    CHECK_EQUAL(fake.transactions(), 3);
+    CHECK(!sensor.isBusy());
+
+    return testResult("asyncTest");
+}
@@ -0,0 +1,112 @@
+// Pins the bus cost of the public methods: transactions, bytes and modeled
+// bus time at 100 kHz, as logged by caliPileFakeI2C. The CALIPILE_BUS_STATS
+// ledger of the instance must agree with the log.
+//
+// Build and run from this directory (run.sh does the same for every test):
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o busCostTest busCostTest.cpp ../../src/*.cpp && ./busCostTest
+#include "caliPileTest.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPileSnapshot snapshot;
+
+struct cost {
+    const char *method;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t busMicros;
+};
+
+void start() {
+    fake.resetLog();
+    sensor.resetBusStats();
+}
+
+void checkCost(const cost &expected) {
+    const caliPileBusStats &stats = sensor.busStats();
+    printf("%-24s %3u transactions %4u bytes %6u us\n", expected.method, fake.transactions(), fake.bytes(), fake.busMicros());
+    CHECK_EQUAL(fake.transactions(), expected.transactions);
+    CHECK_EQUAL(fake.bytes(), expected.bytes);
+    CHECK_EQUAL(fake.busMicros(), expected.busMicros);
+    CHECK_EQUAL(stats.transactions, fake.transactions());
+    CHECK_EQUAL(stats.bytes, fake.bytes());
+    CHECK_EQUAL(stats.busMicros, fake.busMicros());
+}
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    fake.setSample(SENSOR_ADDRESS, 34417, 10484);
+
+    start();
+    sensor.activateSensor();
+    checkCost({"activateSensor", 1, 3, 290});
+
+    start();
+    CHECK(sensor.TempCalculations());
+    checkCost({"TempCalculations", 3, 41, 3760});
+
+    // First setup reads the configuration block, then writes the changed run
+    start();
+    sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    checkCost({"initMotion", 2, 22, 2030});
+
+    // Same settings again: the shadow copy makes it free
+    start();
+    sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    checkCost({"initMotion (unchanged)", 0, 0, 0});
+
+    start();
+    sensor.readSnapshot(snapshot);
+    checkCost({"readSnapshot", 1, 22, 2010});
+    CHECK_EQUAL(snapshot.objectTemp(), 34417);
+    CHECK_EQUAL(snapshot.ambientTemp(), 10484);
+
+    start();
+    CHECK_EQUAL(sensor.getObjectTemp(), 34417);
+    checkCost({"getObjectTemp", 1, 6, 570});
+
+    start();
+    sensor.getAmbientTemp();
+    checkCost({"getAmbientTemp", 1, 5, 480});
+
+    start();
+    sensor.getObjectTempLP1();
+    checkCost({"getObjectTempLP1", 1, 6, 570});
+
+    start();
+    sensor.getObjectTempLP2();
+    checkCost({"getObjectTempLP2", 1, 6, 570});
+
+    start();
+    sensor.getObjectTempLP2Frozen();
+    checkCost({"getObjectTempLP2Frozen", 1, 6, 570});
+
+    start();
+    sensor.getPresenceStat();
+    checkCost({"getPresenceStat", 1, 4, 390});
+
+    // INTERRUPT_STATUS latches until it is read
+    fake.raiseInterrupt(SENSOR_ADDRESS, INT_PRESENCE | INT_MOTION);
+    start();
+    CHECK_EQUAL(sensor.interruptStatus(), INT_PRESENCE | INT_MOTION);
+    checkCost({"interruptStatus", 1, 4, 390});
+    CHECK_EQUAL(sensor.interruptStatus(), 0);
+
+    // A read from an absent device is a NACK, not a truncated read
+    caliPile missing(0, bus, SENSOR_ADDRESS + 1);
+    missing.resetBusStats();
+    caliPileSnapshot empty;
+    CHECK_EQUAL(missing.readSnapshot(empty), BUS_NACK);
+    CHECK_EQUAL(missing.busStats().nacks, 1);
+    CHECK_EQUAL(missing.busStats().shortReads, 0);
+    CHECK_EQUAL(missing.busStats().busErrors, 0);
+
+    // The general call reload returns the configuration registers to 0
+    sensor.activateSensor();
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, SLP12), 0);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, SRC_SELECT), 0);
+
+    return testResult("busCostTest");
+}
@@ -0,0 +1,60 @@
+#ifndef caliPileTest_h
+#define caliPileTest_h
+
+/*
+ * Checks shared by the host tests. Each test is a program of its own that
+ * runs the library against caliPileFakeI2C; run.sh builds and runs them all.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "caliPile.h"
+#include "caliPileLinuxI2C.h"
+#include "caliPileFakeI2C.h"
+
+static unsigned testFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            testFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+    do { \
+        long long actualValue = (long long) (actual); \
+        long long expectedValue = (long long) (expected); \
+        if (actualValue != expectedValue) { \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, actualValue, expectedValue); \
+            testFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        double actualValue = (double) (actual); \
+        double expectedValue = (double) (expected); \
+        if (!(fabs(actualValue - expectedValue) <= (tolerance))) { \
+            printf("%s:%d: %s is %.4f, expected %.4f\n", __FILE__, __LINE__, #actual, actualValue, expectedValue); \
+            testFailures++; \
+        } \
+    } while (0)
+
+/**
+ * @brief Prints the verdict of a test program.
+ *
+ * @param name The name of the test.
+ * @return The exit code for main(), 0 if every check passed.
+ */
+static int testResult(const char *name) {
+    if (testFailures == 0) {
+        printf("%s: ok\n", name);
+        return 0;
+    }
+    printf("%s: %u failed\n", name, testFailures);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,79 @@
+// Checks which EEPROM images TempCalculations() accepts and the k each
+// sensor variant converts with.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o calibrationTest calibrationTest.cpp ../../src/*.cpp && ./calibrationTest
+#include "caliPileTest.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPile missing(0, bus, SENSOR_ADDRESS + 1);
+caliPile restored(0, bus, SENSOR_ADDRESS);
+
+// Rewrites the checksum cells to match the image
+void sealImage() {
+    uint16_t sum = 0;
+    for (uint8_t reg = EEPROM_PROTOCOL; reg <= SLAVE_ADDRESS; reg++) {
+        if (reg != EEPROM_CHECKSUM && reg != EEPROM_CHECKSUM + 1) {
+            sum += fake.getRegister(SENSOR_ADDRESS, reg);
+        }
+    }
+    fake.setRegister(SENSOR_ADDRESS, EEPROM_CHECKSUM, sum >> 8);
+    fake.setRegister(SENSOR_ADDRESS, EEPROM_CHECKSUM + 1, sum & 0xFF);
+}
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+
+    CHECK(sensor.TempCalculations());
+    CHECK_EQUAL(sensor.M, 172);
+
+    // UOUT1 at 25 °C ambient is TOBJ1 by definition of k, for either
+    // exponent; a variant fixed at compile time uses k of its own exponent
+    float tobj1 = sensor.TOBJ1 + 273.15f;
+    CHECK_NEAR(sensor.calcObjectTemp<caliPileTPiS1S>(sensor.UOUT1, 298.15f), tobj1, 0.05);
+    CHECK_NEAR(sensor.calcObjectTemp<caliPileTPiS1T>(sensor.UOUT1, 298.15f), tobj1, 0.05);
+    CHECK_NEAR(sensor.calcObjectTemp<caliPileTPiS1S>(sensor.UOUT1, 298.15f), tobj1, 0.05);
+    CHECK_NEAR(sensor.calcObjectTemp(sensor.UOUT1, 298.15f), tobj1, 0.05);
+
+    // A cached calibration is checked against the sensor's checksum cells,
+    // read with EEPROM access on and left off afterwards
+    caliPileCalibration cal = sensor.calibration();
+    CHECK(!restored.isCalibrationValid());
+    fake.resetLog();
+    CHECK(restored.loadCalibration(cal));
+    CHECK(restored.isCalibrationValid());
+    CHECK_EQUAL(fake.transactions(), 3);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, EEPROM_CONTROL), 0);
+    CHECK_EQUAL(restored.M, sensor.M);
+
+    // Another part at the address, or a cache that went stale, is rejected
+    caliPile replaced(0, bus, SENSOR_ADDRESS);
+    cal.checksum++;
+    CHECK(!replaced.loadCalibration(cal));
+    CHECK(!replaced.isCalibrationValid());
+    cal = sensor.calibration();
+    cal.address = SENSOR_ADDRESS + 1;
+    CHECK(!missing.loadCalibration(cal));
+    CHECK_EQUAL(missing.lastError(), BUS_NACK);
+
+    // Nobody answers: the zeros left by the failed read are not a calibration
+    CHECK(!missing.TempCalculations());
+    CHECK(!missing.isCalibrationValid());
+    CHECK_EQUAL(missing.lastError(), BUS_NACK);
+
+    // M below 100 counts/K rounds to 0 and would divide by zero
+    fake.setRegister(SENSOR_ADDRESS, EEPROM_M, 0);
+    fake.setRegister(SENSOR_ADDRESS, EEPROM_M + 1, 99);
+    sealImage();
+    CHECK(!sensor.TempCalculations());
+
+    // An image of zeros has a matching checksum
+    for (uint8_t reg = EEPROM_PROTOCOL; reg <= SLAVE_ADDRESS; reg++) {
+        fake.setRegister(SENSOR_ADDRESS, reg, 0);
+    }
+    CHECK(!sensor.TempCalculations());
+    CHECK(!sensor.isCalibrationValid());
+
+    return testResult("calibrationTest");
+}
@@ -0,0 +1,130 @@
+// Writes a capture, then decodes it whole, from the middle and with line
+// noise, and checks that the reader never hands on a wrong sample.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o captureTest captureTest.cpp ../../src/*.cpp && ./captureTest
+#include <vector>
+#include "caliPileTest.h"
+#include "caliPileCapture.h"
+
+#define SAMPLES 200
+
+class bufferPrint : public Print {
+public:
+    size_t write(uint8_t value) {
+        bytes.push_back(value);
+        return 1;
+    }
+    std::vector<uint8_t> bytes;
+};
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+std::vector<caliPileCaptureSample> written;
+
+// Sets the 20-bit TPOBJLP1 and TPOBJLP2 fields, which share register 7
+void setLowPass(uint32_t lp1, uint32_t lp2) {
+    fake.setRegister(SENSOR_ADDRESS, TPOBJLP1, (lp1 >> 12) & 0xFF);
+    fake.setRegister(SENSOR_ADDRESS, TPOBJLP1 + 1, (lp1 >> 4) & 0xFF);
+    fake.setRegister(SENSOR_ADDRESS, TPOBJLP2, ((lp1 & 0x0F) << 4) | ((lp2 >> 16) & 0x0F));
+    fake.setRegister(SENSOR_ADDRESS, TPOBJLP2 + 1, (lp2 >> 8) & 0xFF);
+    fake.setRegister(SENSOR_ADDRESS, TPOBJLP2 + 2, lp2 & 0xFF);
+}
+
+// Decodes bytes and counts the samples that match one written, in order
+unsigned decodeAll(const std::vector<uint8_t> &bytes, unsigned &wrong) {
+    caliPileCaptureReader reader;
+    size_t offset = 0, consumed = 0;
+    unsigned matched = 0, next = 0;
+    wrong = 0;
+    while (offset < bytes.size()) {
+        uint8_t result = reader.decode(&bytes[offset], bytes.size() - offset, consumed);
+        if (result == CAPTURE_NEED_MORE) {
+            break;
+        }
+        offset += consumed;
+        if (result != CAPTURE_SAMPLE) {
+            continue;
+        }
+        const caliPileCaptureSample &s = reader.sample();
+        while (next < written.size() && written[next].timestamp != s.timestamp) {
+            next++;
+        }
+        if (next == written.size() || written[next].objectTemp != s.objectTemp || written[next].ambientTemp != s.ambientTemp
+                || written[next].objectTempLP1Raw != s.objectTempLP1Raw || written[next].objectTempLP2Raw != s.objectTempLP2Raw
+                || written[next].objectTempLP1() != s.objectTempLP1() || written[next].objectTempLP2() != s.objectTempLP2()) {
+            wrong++;
+        } else {
+            matched++;
+        }
+    }
+    return matched;
+}
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    bufferPrint out;
+    caliPileCaptureWriter writer(out, 3);
+    writer.begin(sensor);
+    CHECK_EQUAL(out.bytes.size(), CAPTURE_HEADER_LENGTH);
+
+    caliPileSnapshot snapshot;
+    unsigned lowBits = 0;
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        // Slow drift with a jump now and then that needs a key sample; the
+        // LP fields step by amounts that are not multiples of 8
+        uint32_t object = 60000 + i * 37 + (i % 50 == 25 ? 40000 : 0);
+        fake.setSample(SENSOR_ADDRESS, object, 20000 + i);
+        setLowPass(0x40000 + i * 37 + (i % 50 == 25 ? 0x8000 : 0), 0x30000 + i * 5);
+        sensor.readSnapshot(snapshot);
+        caliPileCaptureSample s;
+        s.timestamp = 1000 + i * 30;
+        s.objectTemp = snapshot.objectTemp();
+        s.ambientTemp = snapshot.ambientTemp();
+        s.objectTempLP1Raw = snapshot.objectTempLP1Raw();
+        s.objectTempLP2Raw = snapshot.objectTempLP2Raw();
+        CHECK_EQUAL(s.objectTempLP1(), snapshot.objectTempLP1());
+        CHECK_EQUAL(s.objectTempLP2(), snapshot.objectTempLP2());
+        if (s.objectTempLP1Raw % 8 != 0 && s.objectTempLP2Raw % 8 != 0) {
+            lowBits++;
+        }
+        written.push_back(s);
+        writer.write(s.timestamp, snapshot);
+    }
+    CHECK_EQUAL(writer.bytesWritten(), out.bytes.size());
+    CHECK(lowBits > SAMPLES / 2);
+
+    // The whole capture decodes completely
+    unsigned wrong;
+    CHECK_EQUAL(decodeAll(out.bytes, wrong), SAMPLES);
+    CHECK_EQUAL(wrong, 0);
+    caliPileCaptureReader reader;
+    size_t consumed;
+    CHECK_EQUAL(reader.decode(&out.bytes[0], out.bytes.size(), consumed), CAPTURE_HEADER);
+    CHECK_EQUAL(consumed, CAPTURE_HEADER_LENGTH);
+    CHECK_EQUAL(reader.header(3).address, SENSOR_ADDRESS);
+
+    // Joining mid-item: samples resume at the next key sample
+    std::vector<uint8_t> joined(out.bytes.begin() + 500, out.bytes.end());
+    unsigned late = decodeAll(joined, wrong);
+    CHECK(late > 0 && late < SAMPLES);
+    CHECK_EQUAL(wrong, 0);
+
+    // Corrupted bytes are dropped and no delta is applied past them
+    std::vector<uint8_t> noisy = out.bytes;
+    for (size_t i = 300; i < noisy.size(); i += 211) {
+        noisy[i] ^= 0x5A;
+    }
+    unsigned survived = decodeAll(noisy, wrong);
+    CHECK(survived > 0 && survived < SAMPLES);
+    CHECK_EQUAL(wrong, 0);
+
+    // Reserved item bits are rejected even with a matching CRC
+    std::vector<uint8_t> reserved(out.bytes.begin(), out.bytes.begin() + CAPTURE_HEADER_LENGTH + CAPTURE_KEY_LENGTH);
+    uint8_t *key = &reserved[CAPTURE_HEADER_LENGTH];
+    key[1] |= 0x10;
+    key[CAPTURE_KEY_LENGTH - 1] = caliPileCaptureCrc8(&key[1], CAPTURE_KEY_LENGTH - 2);
+    CHECK_EQUAL(decodeAll(reserved, wrong), 0);
+
+    return testResult("captureTest");
+}
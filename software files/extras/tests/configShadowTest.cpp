@@ -0,0 +1,85 @@
+// Checks that the configuration shadow copy stays true to the sensor
+// across failed reads and writes and the general call reload.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o configShadowTest configShadowTest.cpp ../../src/*.cpp && ./configShadowTest
+#include "caliPileTest.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPile missing(0, bus, SENSOR_ADDRESS + 1);
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+
+    // A failed read learns nothing, so a flush writes only what was set:
+    // two single registers rather than one run padded with stale bytes
+    missing.syncConfig();
+    CHECK(!missing.isConfigKnown(SLP12));
+    CHECK(!missing.isConfigKnown(TPOT_THR));
+    missing.setConfig(TP_PRES_THLD, 0x22);
+    missing.setConfig(INT_MASK, 0x08);
+    fake.addSensor(SENSOR_ADDRESS + 1);
+    fake.resetLog();
+    missing.flushConfig();
+    CHECK_EQUAL(fake.transactions(), 2);
+
+    // Nothing is built from registers that could not be read
+    caliPile absent(0, bus, 0x10);
+    CHECK_EQUAL(absent.configValue(SRC_SELECT), 0);
+    fake.resetLog();
+    CHECK_EQUAL(absent.initTimer(120), 0);
+    absent.initTPotThreshHold(100);
+    CHECK(absent.beginMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30));
+    uint8_t result;
+    while ((result = absent.poll()) == ASYNC_BUSY) {
+    }
+    CHECK_EQUAL(result, ASYNC_ERROR);
+    // Three configuration reads, no write
+    CHECK_EQUAL(fake.transactions(), 3);
+    CHECK(!absent.isConfigKnown(SRC_SELECT));
+
+    // A NACKed flush keeps the changes pending until the sensor answers
+    caliPile late(0, bus, SENSOR_ADDRESS + 2);
+    late.setConfig(TP_PRES_THLD, 0x22);
+    late.flushConfig();
+    CHECK_EQUAL(late.lastError(), BUS_NACK);
+    fake.addSensor(SENSOR_ADDRESS + 2);
+    fake.resetLog();
+    late.flushConfig();
+    CHECK_EQUAL(fake.transactions(), 1);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 2, TP_PRES_THLD), 0x22);
+
+    // A failed write ends beginMotion() with an error, not as done
+    caliPile later(0, bus, SENSOR_ADDRESS + 3);
+    later.syncConfig();
+    later.setConfig(SRC_SELECT, 0);
+    CHECK(later.beginMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30));
+    while ((result = later.poll()) == ASYNC_BUSY) {
+    }
+    CHECK_EQUAL(result, ASYNC_ERROR);
+    CHECK(!later.isBusy());
+    fake.addSensor(SENSOR_ADDRESS + 3);
+    later.flushConfig();
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 3, TP_PRES_THLD), 0x22);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 3, SLP12), LP_1s << 4 | LP_8s);
+
+    // The reload clears the registers; activation must not leave the shadow stale
+    sensor.activateSensor();
+    sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TP_PRES_THLD), 0x22);
+    sensor.activateSensor();
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TP_PRES_THLD), 0);
+    sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TP_PRES_THLD), 0x22);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, SLP12), LP_1s << 4 | LP_8s);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, INT_MASK), 0x1C);
+
+    // A new source and cycle replace the old ones instead of ORing into them
+    sensor.setConfig(SRC_SELECT, 0x10 | src_TPOBJLP1_TPOBJLP2FRZN << 2 | ms240);
+    sensor.flushConfig();
+    sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, SRC_SELECT), 0x10 | src_TPOBJLP1_TPOBJLP2 << 2 | ms30);
+
+    return testResult("configShadowTest");
+}
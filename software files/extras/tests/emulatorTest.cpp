@@ -0,0 +1,104 @@
+// Replays scripted scenes through caliPileEmulator and checks the presence
+// and motion events, and that the filters run at the conversion rate
+// whatever cycle time SRC_SELECT selects.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o emulatorTest emulatorTest.cpp ../../src/*.cpp && ./emulatorTest
+#include "caliPileTest.h"
+#include "caliPileEmulator.h"
+
+// TPOBJECT counts of an empty room, TPAMBIENT of about 22 °C
+#define ROOM 40000
+#define AMBIENT 10484
+
+// Sets up a model the way initMotion() sets up the sensor
+void configure(caliPileEmulator &model, uint8_t cycleTime) {
+    model.setRegister(SLP12, LP_8s << 4 | LP_0_25s);
+    model.setRegister(SLP3, LP_1s);
+    model.setRegister(SRC_SELECT, src_TPOBJLP1_TPOBJLP2 << 2 | cycleTime);
+    model.setRegister(TP_PRES_THLD, 0x22);
+    model.setRegister(TP_MOT_THLD, 0x0A);
+    model.setRegister(INT_MASK, INT_PRESENCE | INT_MOTION);
+    model.reset();
+}
+
+// Steps a constant scene for count conversions; returns the interrupts raised
+uint8_t hold(caliPileEmulator &model, uint32_t object, unsigned count) {
+    uint8_t raised = 0;
+    for (unsigned i = 0; i < count; i++) {
+        model.step(object, AMBIENT);
+        raised |= model.interruptStatus();
+    }
+    return raised;
+}
+
+// Steps a scene rising by slope counts per conversion; returns the interrupts raised
+uint8_t ramp(caliPileEmulator &model, uint32_t from, uint32_t slope, unsigned count) {
+    uint8_t raised = 0;
+    for (unsigned i = 0; i < count; i++) {
+        model.step(from + slope * i, AMBIENT);
+        raised |= model.interruptStatus();
+    }
+    return raised;
+}
+
+int main() {
+    caliPileEmulator model;
+
+    // Empty room, also with a few counts of noise: no event
+    configure(model, ms30);
+    CHECK_EQUAL(hold(model, ROOM, 1000), 0);
+    uint8_t raised = 0;
+    for (unsigned i = 0; i < 1000; i++) {
+        model.step(ROOM + (i * 7) % 5, AMBIENT);
+        raised |= model.interruptStatus();
+    }
+    CHECK_EQUAL(raised, 0);
+
+    // Someone walks in: motion and presence at once, motion ends when LP1
+    // settles while presence stays
+    raised = hold(model, ROOM + 200, 10);
+    CHECK_EQUAL(raised & (INT_PRESENCE | INT_MOTION), INT_PRESENCE | INT_MOTION);
+    CHECK_EQUAL(raised & (SIGN_PRESENCE | SIGN_MOTION), 0);
+    hold(model, ROOM + 200, 100);
+    CHECK_EQUAL(model.state().chipStatus & (INT_PRESENCE | INT_MOTION), INT_PRESENCE);
+
+    // LP2 (8 s) takes the person in, so presence ends after a while
+    hold(model, ROOM + 200, 2000);
+    CHECK_EQUAL(model.state().chipStatus & INT_PRESENCE, 0);
+
+    // Leaving is a negative motion event
+    raised = hold(model, ROOM, 10);
+    CHECK(raised & INT_MOTION);
+    CHECK(raised & SIGN_MOTION);
+
+    // A slow approach, 2 counts per conversion, moves LP1 too little per
+    // 30 ms to count as motion but enough over 240 ms
+    configure(model, ms30);
+    hold(model, ROOM, 100);
+    CHECK_EQUAL(ramp(model, ROOM, 2, 50) & INT_MOTION, 0);
+    configure(model, ms240);
+    hold(model, ROOM, 100);
+    CHECK(ramp(model, ROOM, 2, 50) & INT_MOTION);
+
+    // The cycle time changes what motion compares, not the filters: the
+    // same scene gives the same LP1 and LP2 on every step
+    caliPileEmulator slow;
+    configure(model, ms30);
+    configure(slow, ms240);
+    bool same = true;
+    for (unsigned i = 0; i < 500; i++) {
+        uint32_t object = ROOM + (i >= 100 && i < 300 ? 150 : 0);
+        const caliPileEmulatorState &fast = model.step(object, AMBIENT);
+        const caliPileEmulatorState &other = slow.step(object, AMBIENT);
+        same &= fast.objectTempLP1 == other.objectTempLP1 && fast.objectTempLP2 == other.objectTempLP2;
+    }
+    CHECK(same);
+
+    // LP1 (0.25 s) is within a count of a step after 1 s of conversions
+    configure(model, ms240);
+    hold(model, ROOM, 1);
+    hold(model, ROOM + 100, 1000 / EMULATOR_CONVERSION_MS);
+    CHECK_NEAR(model.state().objectTempLP1, ROOM + 100, 2);
+
+    return testResult("emulatorTest");
+}
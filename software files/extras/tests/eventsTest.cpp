@@ -0,0 +1,63 @@
+// Queues several INT pin interrupts before service() and checks that the
+// clear-on-read status yields one event, not one real and several empty ones.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o eventsTest eventsTest.cpp ../../src/*.cpp && ./eventsTest
+#include "caliPileTest.h"
+#include "caliPileEvents.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPileEventQueue events(sensor);
+
+caliPileEvent received;
+unsigned eventCount = 0;
+
+void onEvent(const caliPileEvent &event) {
+    received = event;
+    eventCount++;
+}
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    fake.setRegister(SENSOR_ADDRESS, TPPRESENCE, 40);
+    fake.setRegister(SENSOR_ADDRESS, TPMOTION, 12);
+
+    // Three interrupts, one latched status: one read, one event
+    events.onInterrupt();
+    uint32_t first = micros();
+    delay(1);
+    events.onInterrupt();
+    events.onInterrupt();
+    fake.raiseInterrupt(SENSOR_ADDRESS, INT_PRESENCE | INT_MOTION);
+    fake.resetLog();
+    CHECK_EQUAL(events.service(onEvent), 1);
+    CHECK_EQUAL(fake.transactions(), 1);
+    CHECK_EQUAL(eventCount, 1);
+    CHECK_EQUAL(received.interrupts, 3);
+    CHECK_EQUAL(received.status, INT_PRESENCE | INT_MOTION);
+    CHECK_EQUAL(received.presence, 40);
+    CHECK_EQUAL(received.motion, 12);
+    CHECK(first - received.timestamp < 1000);
+    CHECK_EQUAL(events.pending(), 0);
+
+    // Nothing queued: no bus traffic
+    fake.resetLog();
+    CHECK_EQUAL(events.service(onEvent), 0);
+    CHECK_EQUAL(fake.transactions(), 0);
+
+    // An edge with no latched status is consumed without an event
+    events.onInterrupt();
+    CHECK_EQUAL(events.service(onEvent), 0);
+    CHECK_EQUAL(eventCount, 1);
+    CHECK_EQUAL(events.pending(), 0);
+
+    // A failed read keeps the queue
+    caliPile missing(0, bus, SENSOR_ADDRESS + 1);
+    caliPileEventQueue missingEvents(missing);
+    missingEvents.onInterrupt();
+    CHECK_EQUAL(missingEvents.service(onEvent), 0);
+    CHECK_EQUAL(missingEvents.pending(), 1);
+
+    return testResult("eventsTest");
+}
@@ -0,0 +1,62 @@
+// Converts the golden scenes of the benchmark with caliPileFixedPoint, built
+// from a calibration loaded without the float k, and checks the results.
+// Then sweeps the raw ambient and object range against the float path and
+// checks the bound documented in caliPileFixedPoint.h.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o fixedPointTest fixedPointTest.cpp ../../src/*.cpp && ./fixedPointTest
+#include "caliPileTest.h"
+#include "caliPileFixedPoint.h"
+#include "../benchmark/caliPileGolden.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPileFixedPoint fixedPoint;
+
+// Largest difference to the float path, in degrees Kelvin
+const float sweepBound = 0.01f;
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    CHECK(sensor.TempCalculations());
+    // Loading the calibration leaves k to the float conversions
+    CHECK_EQUAL(sensor.k, 0);
+    CHECK(fixedPoint.build(sensor));
+    CHECK_EQUAL(sensor.k, 0);
+
+    for (uint8_t i = 0; i < SCENES; i++) {
+        uint32_t object = scenes[i].objectTemp();
+        uint16_t ambient = scenes[i].ambientTemp();
+        CHECK_NEAR(fixedPoint.ambientTemp(ambient) / 100.0, expected[i].ambientK, 0.005);
+        CHECK_NEAR(fixedPoint.objectTemp(object, ambient) / 100.0, expected[i].objectK, fixedTolerance);
+    }
+
+    // The float path derives the same k on first use
+    CHECK_NEAR(sensor.conversionK(), expectedK, expectedK * 1e-5);
+
+    // Every 15 bit ambient and 17 bit object reading on a grid, skipping
+    // pairs that imply no physical temperature
+    float ambientError = 0;
+    float objectError = 0;
+    uint32_t points = 0;
+    for (uint32_t ambientRaw = 0; ambientRaw <= 0x7FFF; ambientRaw += 32) {
+        float ambient = sensor.calcAmbientTemp(ambientRaw);
+        if (ambient < 200.0f || ambient > 500.0f) {
+            continue;
+        }
+        ambientError = fmaxf(ambientError, fabsf(fixedPoint.ambientTemp(ambientRaw) / 100.0f - ambient));
+        for (uint32_t objectRaw = 0; objectRaw < 0x20000; objectRaw += 61) {
+            float reference = sensor.calcObjectTemp(objectRaw, ambient);
+            if (isnan(reference) || reference < 200.0f || reference > 500.0f) {
+                continue;
+            }
+            objectError = fmaxf(objectError, fabsf(fixedPoint.objectTemp(objectRaw, ambientRaw) / 100.0f - reference));
+            points++;
+        }
+    }
+    CHECK(points > 1000000);
+    CHECK(ambientError <= sweepBound);
+    CHECK(objectError <= sweepBound);
+
+    return testResult("fixedPointTest");
+}
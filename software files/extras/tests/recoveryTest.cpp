@@ -0,0 +1,62 @@
+// Holds the emulated bus to force a timeout and checks that the recovery,
+// whose general call reloads every sensor, leaves no sibling behind.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o recoveryTest recoveryTest.cpp ../../src/*.cpp && ./recoveryTest
+#include "caliPileTest.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensorA(0, bus, SENSOR_ADDRESS);
+caliPile sensorB(0, bus, SENSOR_ADDRESS + 1);
+caliPileSnapshot snapshot;
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    fake.addSensor(SENSOR_ADDRESS + 1);
+
+    sensorA.activateSensor();
+    sensorA.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    sensorB.initMotion(LP_4s, LP_2s, src_TPOBJ_TPOBJLP2, ms60);
+    sensorB.initTpPresenceThreshHold(0x40);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 1, TP_PRES_THLD), 0x40);
+    CHECK_EQUAL(sensorA.initTimer(90), 90);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TMR_INT), 2);
+
+    // A times out, recovers and reloads both sensors
+    fake.setStuck(true);
+    CHECK_EQUAL(sensorA.readSnapshot(snapshot), BUS_TIMEOUT);
+    CHECK_EQUAL(sensorA.busStats().recoveries, 1);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, INT_MASK), 0);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TMR_INT), 0);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 1, TP_PRES_THLD), 0);
+
+    // The sensors do not answer until the reload is done
+    CHECK_EQUAL(sensorA.readSnapshot(snapshot), BUS_NACK);
+    delay(RELOAD_MS);
+
+    // Sampling alone restores the interrupt mask and the timer
+    CHECK_EQUAL(sensorA.readSnapshot(snapshot), BUS_OK);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, INT_MASK), 0x1C | INT_TIMER);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TMR_INT), 2);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, SLP12), LP_1s << 4 | LP_8s);
+    fake.resetLog();
+    sensorA.readSnapshot(snapshot);
+    CHECK_EQUAL(fake.transactions(), 1);
+
+    // The sibling restores its own configuration on its next access
+    sensorB.readSnapshot(snapshot);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, TP_PRES_THLD), 0x22);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 1, SLP12), LP_2s << 4 | LP_4s);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 1, TP_PRES_THLD), 0x40);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 1, SRC_SELECT), src_TPOBJ_TPOBJLP2 << 2 | ms60);
+
+    // Setting a value the sibling had before the reload is not skipped
+    fake.setStuck(true);
+    sensorA.readSnapshot(snapshot);
+    delay(RELOAD_MS);
+    sensorB.initTpPresenceThreshHold(0x40);
+    sensorB.flushConfig();
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS + 1, TP_PRES_THLD), 0x40);
+
+    return testResult("recoveryTest");
+}
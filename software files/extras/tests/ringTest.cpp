@@ -0,0 +1,53 @@
+// Runs the producer and the consumer of a caliPileRing in two threads and
+// checks that every sample arrives once, in order and complete. Build with
+// CXXFLAGS=-fsanitize=thread to check the index ordering as well.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o ringTest ringTest.cpp ../../src/*.cpp && ./ringTest
+#include <thread>
+#include "caliPileTest.h"
+#include "caliPileRing.h"
+
+#define SAMPLES 2000
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPileRing<8> ring(sensor);
+
+unsigned stored = 0;
+
+// The host INT pin reads LOW; the timer flag makes each read a sample
+void produce() {
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        while (ring.available() == 8) {
+            std::this_thread::yield();
+        }
+        fake.setSample(SENSOR_ADDRESS, i * 2, i);
+        fake.raiseInterrupt(SENSOR_ADDRESS, INT_TIMER);
+        stored += ring.service();
+    }
+}
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    std::thread producer(produce);
+
+    uint32_t expected = 0;
+    unsigned wrong = 0;
+    while (expected < SAMPLES) {
+        const caliPileSample *span;
+        uint16_t count = ring.borrow(span);
+        for (uint16_t i = 0; i < count; i++, expected++) {
+            wrong += span[i].snapshot.objectTemp() != expected * 2 || span[i].snapshot.ambientTemp() != expected;
+        }
+        ring.release(count);
+    }
+    producer.join();
+
+    CHECK_EQUAL(stored, SAMPLES);
+    CHECK_EQUAL(wrong, 0);
+    CHECK_EQUAL(ring.available(), 0);
+    CHECK_EQUAL(ring.dropped(), 0);
+
+    return testResult("ringTest");
+}
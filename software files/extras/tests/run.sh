@@ -0,0 +1,19 @@
+#!/bin/sh
+# Builds and runs the host tests against the emulated bus of caliPileFakeI2C.
+# Needs g++ on Linux. Extra compiler flags may be passed in CXXFLAGS.
+#
+#   ./run.sh
+cd "$(dirname "$0")" || exit 1
+out=$(mktemp -d) || exit 1
+status=0
+for test in *Test.cpp; do
+    name=${test%.cpp}
+    if g++ -std=c++11 -Wall -Wextra -pthread -DCALIPILE_BUS_STATS $CXXFLAGS -I../../src -o "$out/$name" "$test" ../../src/*.cpp; then
+        "$out/$name" || status=1
+    else
+        echo "$name: build failed"
+        status=1
+    fi
+done
+rm -rf "$out"
+exit $status
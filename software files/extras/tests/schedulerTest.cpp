@@ -0,0 +1,54 @@
+// Steps the scheduler through its levels and checks that a level only
+// touches the cycle time and the presence and motion bits of INT_MASK.
+//
+//   g++ -std=c++11 -pthread -DCALIPILE_BUS_STATS -I../../src -o schedulerTest schedulerTest.cpp ../../src/*.cpp && ./schedulerTest
+#include "caliPileTest.h"
+#include "caliPileScheduler.h"
+
+caliPileFakeI2C fake;
+caliPileLinuxI2C bus("/dev/i2c-fake", caliPileFakeI2C::calls());
+caliPile sensor(0, bus, SENSOR_ADDRESS);
+caliPileScheduler scheduler(sensor);
+caliPileSnapshot snapshot;
+
+// Sleeps until the scheduler is due and services it once
+bool serviceWhenDue() {
+    delay(scheduler.millisUntilDue());
+    return scheduler.service(snapshot);
+}
+
+int main() {
+    fake.addSensor(SENSOR_ADDRESS);
+    sensor.activateSensor();
+    sensor.initMotion(LP_8s, LP_1s, src_TPOBJLP1_TPOBJLP2, ms30);
+    sensor.initTimer(240);
+    sensor.setConfig(INT_MASK, INT_TIMER | INT_AMB_SHOCK);
+    sensor.flushConfig();
+
+    scheduler.setLevel(1, ms60, 10, 0);
+    scheduler.setLevel(2, ms120, 10, INT_PRESENCE | INT_MOTION | INT_TPOT);
+    scheduler.setHysteresis(1, 0);
+    scheduler.begin();
+    CHECK_EQUAL(scheduler.level(), 0);
+
+    // Quiet samples step down one level each
+    CHECK(serviceWhenDue());
+    CHECK_EQUAL(scheduler.level(), 1);
+    CHECK(serviceWhenDue());
+    CHECK_EQUAL(scheduler.level(), 2);
+    uint8_t mask = fake.getRegister(SENSOR_ADDRESS, INT_MASK);
+    CHECK_EQUAL(mask, INT_TIMER | INT_AMB_SHOCK | INT_PRESENCE | INT_MOTION);
+    uint8_t sourceSelect = fake.getRegister(SENSOR_ADDRESS, SRC_SELECT);
+    CHECK_EQUAL(sourceSelect & 0x03, ms120);
+    CHECK_EQUAL(sourceSelect >> 2, src_TPOBJLP1_TPOBJLP2);
+
+    // Activity jumps back to level 0 and masks only the scheduler's bits
+    fake.raiseInterrupt(SENSOR_ADDRESS, INT_PRESENCE);
+    scheduler.wake();
+    CHECK(serviceWhenDue());
+    CHECK_EQUAL(scheduler.level(), 0);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, INT_MASK), INT_TIMER | INT_AMB_SHOCK);
+    CHECK_EQUAL(fake.getRegister(SENSOR_ADDRESS, SRC_SELECT) & 0x03, ms30);
+
+    return testResult("schedulerTest");
+}
@@ -1,54 +1,195 @@
 #include "caliPile.h"
 
+// Set by the INT pin handler of the examples
+bool newInt = false;
+
+#ifndef CALIPILE_LINUX
+static caliPileWire defaultBus(Wire);
+#endif
+
+#ifdef CALIPILE_METHOD_STATS
+/*
+ * Adds the time from construction to destruction to one caliPileMethodStats
+ * entry, so a method is timed on every return path.
+ */
+class caliPileMethodTimer {
+public:
+    caliPileMethodTimer(caliPileMethodStats &entry) : stats(entry), start(micros()) {
+    }
+
+    ~caliPileMethodTimer() {
+        uint32_t elapsed = micros() - start;
+        stats.calls++;
+        stats.totalMicros += elapsed;
+        if (elapsed > stats.maxMicros) {
+            stats.maxMicros = elapsed;
+        }
+    }
+
+private:
+    caliPileMethodStats &stats;
+    uint32_t start;
+};
+
+#define CALIPILE_PROFILE(method) caliPileMethodTimer methodTimer(methods[method])
+#else
+#define CALIPILE_PROFILE(method)
+#endif
+
+/*
+ * Field decoders shared by the single-register getters and caliPileSnapshot.
+ * Each one takes a pointer to the first byte of the field as it sits in the
+ * register map.
+ */
+static uint32_t decodeObjectTemp(const uint8_t *rawData) {
+    return ((uint32_t) ( (uint32_t)rawData[0] << 24) | ( (uint32_t)rawData[1] << 16) | ( (uint32_t)rawData[2] & 0x80) << 8) >> 15;
+}
+
+static uint16_t decodeAmbientTemp(const uint8_t *rawData) {
+    return ((uint16_t)(rawData[0] & 0x7F) << 8) | rawData[1];
+}
+
+// The 20-bit TPOBJLP1 and TPOBJLP2 fields; the getters divide them by 8
+static uint32_t decodeObjectTempLP1Raw(const uint8_t *rawData) {
+    return (((uint32_t) rawData[0] << 16) | ((uint32_t) rawData[1] << 8) | ( (uint32_t)rawData[2] & 0xF0) ) >> 4;
+}
+
+static uint32_t decodeObjectTempLP2Raw(const uint8_t *rawData) {
+    return ((uint32_t) (rawData[0] & 0x0F) << 16) | ((uint32_t) rawData[1] << 8) | rawData[2];
+}
+
+static uint32_t decodeObjectTempLP1(const uint8_t *rawData) {
+    return decodeObjectTempLP1Raw(rawData) / 8;
+}
+
+static uint32_t decodeObjectTempLP2(const uint8_t *rawData) {
+    return decodeObjectTempLP2Raw(rawData) / 8;
+}
+
+static uint16_t decodeAmbientTempLP3(const uint8_t *rawData) {
+    uint16_t temp = ((uint16_t) rawData[0] << 8) | rawData[1];
+    return temp / 2;
+}
+
+static uint32_t decodeObjectTempLP2Frozen(const uint8_t *rawData) {
+    uint32_t temp = ((uint32_t) rawData[0] << 16) | ((uint32_t) rawData[1] << 8) | rawData[2];
+    return temp / 128;
+}
+
+static uint16_t eepromWord(const uint8_t *eeprom, uint8_t reg) {
+    return ((uint16_t) eeprom[reg - EEPROM_PROTOCOL] << 8) | eeprom[reg + 1 - EEPROM_PROTOCOL];
+}
+
+// Maps an endTransmission() style status to a caliPileError
+static uint8_t writeError(uint8_t result) {
+    switch (result) {
+    case 0:
+        return BUS_OK;
+    case 2:
+    case 3:
+        return BUS_NACK;
+    case 5:
+        return BUS_TIMEOUT;
+    default:
+        return BUS_ERROR;
+    }
+}
+
+#ifndef CALIPILE_LINUX
 /**
  * @brief Constructor for the caliPile class.
  * 
- * This constructor initializes an instance of the caliPile class.
+ * Initializes the caliPile object with the specified interrupt pin.
  * 
- * @param intPin Pin number to be used as the interrupt pin. 
+ * @param intPin The interrupt pin to be used for the caliPile object.
  *               This pin will be configured as an input pin.
  */
-//#define TPIS_1S
-#define TPIS_1T
-
-#ifdef TPIS_1S
-float lookUpNumber = (float) 3.8f; 
-#endif
-#ifdef TPIS_1T
-float lookUpNumber = (float) 4.2f;
+caliPile::caliPile(uint8_t intPin) : bus(&defaultBus), deviceAddress(SENSOR_ADDRESS), cycle(ms30),
+        asyncOperation(ASYNC_NONE), asyncStep(0), asyncStart(0), asyncSnapshot(NULL), asyncCallback(NULL), calibrationValid(false),
+        config(), configKnown(0), configDirty(0), busTimeout(BUS_TIMEOUT_US), timeoutApplied(false), recovering(false), busError(BUS_OK), readCount(0), reloadsSeen(0), restorePending(false) {
+    pinMode(intPin, INPUT);
+    interruptPin = intPin;
+    lookup = 0;
+    k = 0.0f;
+    variantK = 0.0f;
+    variantExponent = 0.0f;
+}
 #endif
 
-bool newInt = false;
-
 /**
- * @brief Constructor for the caliPile class.
+ * @brief Constructor for a caliPile reached through a specific bus.
  * 
- * Initializes the caliPile object with the specified interrupt pin.
+ * Use this form when several sensors share a controller, either on different
+ * I2C buses or at different addresses on the same bus.
  * 
  * @param intPin The interrupt pin to be used for the caliPile object.
+ * @param sensorBus The transport used for every register access of this sensor.
+ * @param address The 7-bit I2C address of the sensor.
  */
-caliPile::caliPile(uint8_t intPin) {
+caliPile::caliPile(uint8_t intPin, caliPileBus &sensorBus, uint8_t address) : bus(&sensorBus), deviceAddress(address), cycle(ms30),
+        asyncOperation(ASYNC_NONE), asyncStep(0), asyncStart(0), asyncSnapshot(NULL), asyncCallback(NULL), calibrationValid(false),
+        config(), configKnown(0), configDirty(0), busTimeout(BUS_TIMEOUT_US), timeoutApplied(false), recovering(false), busError(BUS_OK), readCount(0), reloadsSeen(0), restorePending(false) {
     pinMode(intPin, INPUT);
     interruptPin = intPin;
+    lookup = 0;
+    k = 0.0f;
+    variantK = 0.0f;
+    variantExponent = 0.0f;
+}
+
+/**
+ * @brief Returns the I2C address this instance talks to.
+ * 
+ * @return The 7-bit I2C address of the sensor.
+ */
+uint8_t caliPile::address() const {
+    return deviceAddress;
+}
+
+/**
+ * @brief Returns the cycle time configured by initMotion().
+ * 
+ * The cycle time is the interval between the two TP_OBJLP1 points whose
+ * difference is TP_MOTION, so a new motion value appears once per cycle.
+ * It does not change the conversion rate of the sensor. Until initMotion()
+ * is called the shortest cycle (ms30) is assumed.
+ * 
+ * @return The cycle time in milliseconds (30, 60, 120 or 240).
+ */
+uint16_t caliPile::cycleTimeMs() const {
+    return 30 << cycle;
+}
+
+/**
+ * @brief Tells whether two instances share the same bus transport.
+ * 
+ * @param other The instance to compare with.
+ * @return true if both talk through the same caliPileBus.
+ */
+bool caliPile::sameBus(const caliPile &other) const {
+    return bus == other.bus;
 }
 
 /**
  * @brief Activates the sensor by sending the call and reload command.
  * 
  * This function activates the sensor by sending the call and reload command.
- * It writes the appropriate values to the registers and introduces a delay
- * to allow the sensor to initialize.
+ * It writes the appropriate values to the registers and waits 10 ms
+ * to allow the sensor to initialize. Use beginActivate() to avoid blocking.
  * 
  * @note This function assumes that the necessary registers have been properly configured before calling it.
  *       It is important to ensure that the appropriate register settings are applied before activating the sensor.
  */
 void caliPile::activateSensor() {
-    writeRegister(0x00, 0x04, 0x00); // Call and reload command
-    delay(10);
+    CALIPILE_PROFILE(STAT_ACTIVATE);
+    finishAsync();
+    beginActivate();
+    finishAsync();
 }
 
 uint8_t caliPile::interruptStatus() {
-    uint8_t tempValue = readRegister(SENSOR_ADDRESS, INTERRUPT_STATUS);
+    CALIPILE_PROFILE(STAT_INTERRUPT_STATUS);
+    uint8_t tempValue = readRegister(deviceAddress, INTERRUPT_STATUS);
     return tempValue;
 }
 
@@ -59,6 +200,8 @@ uint8_t caliPile::interruptStatus() {
  * configuring the necessary registers with the provided parameters.
  * It sets the LPTime1 and LPTime2 values, selects the temperature source,
  * configures the cycle time, and sets the presence and motion thresholds.
+ * It blocks until all registers are written; beginMotion() does the same
+ * one transaction per poll().
  * 
  * @param LPTime1 The value for LPTime1 register. Determines the low power time duration.
  * @param LPTime2 The value for LPTime2 register. Determines the low power time duration.
@@ -66,40 +209,328 @@ uint8_t caliPile::interruptStatus() {
  * @param cycleTime The cycle time value for the SRC_SELECT register. Determines the measurement cycle time.
  */
 void caliPile::initMotion(uint8_t LPTime1, uint8_t LPTime2, uint8_t tempSource, uint8_t cycleTime) {
-    writeRegister(SENSOR_ADDRESS, INT_MASK, 0x1C);
-    writeRegister(SENSOR_ADDRESS, SLP12, LPTime2 << 4 | LPTime1);
-    uint8_t temp = readRegister(SENSOR_ADDRESS, SRC_SELECT); 
-    writeRegister(SENSOR_ADDRESS, SRC_SELECT, temp | tempSource << 2 | cycleTime);
-    writeRegister(SENSOR_ADDRESS, TP_PRES_THLD, 0x22); // presence threshold
-    writeRegister(SENSOR_ADDRESS, TP_MOT_THLD, 0x0A); // motion threshold
+    CALIPILE_PROFILE(STAT_INIT_MOTION);
+    finishAsync();
+    beginMotion(LPTime1, LPTime2, tempSource, cycleTime);
+    finishAsync();
 }
 
 /**
  * @brief Perform temperature calculations based on sensor EEPROM data.
  * 
- * This function reads EEPROM data from the sensor, performs temperature calculations using the data,
- * and calculates the value of 'k' based on the formula provided.
+ * This function reads the whole EEPROM image (EEPROM_PROTOCOL..SLAVE_ADDRESS) in
+ * a single burst, verifies its checksum and extracts the calibration constants.
+ * It blocks until done; beginCalibration() does the same one transaction per poll().
+ * Only integer arithmetic is used, so caliPileFixedPoint builds on it without
+ * powf(); 'k' is derived by the first float conversion, see conversionK().
+ * 
+ * @return true if the EEPROM image was read, its checksum matches and M is nonzero.
  */
-void caliPile::TempCalculations() {
-    writeRegister(SENSOR_ADDRESS, EEPROM_CONTROL, 0x80);
-    readRegisters(SENSOR_ADDRESS, EEPROM_PTAT25, 2, &tempData[0]);
-    PTAT25 = ((uint16_t) tempData[0] << 8) | tempData[1];
-    readRegisters(SENSOR_ADDRESS, EEPROM_M, 2, &tempData[0]);
-    M = ((uint16_t) tempData[0] << 8) | tempData[1];
+bool caliPile::TempCalculations() {
+    CALIPILE_PROFILE(STAT_TEMP_CALCULATIONS);
+    finishAsync();
+    beginCalibration();
+    finishAsync();
+    return calibrationValid;
+}
+
+/**
+ * @brief Extracts the calibration constants from an EEPROM image.
+ * 
+ * An image of zeros, as read with EEPROM access off, has a matching
+ * checksum too; it is rejected like any image with M below 100.
+ * 
+ * @param eeprom The EEPROM_LENGTH bytes read from EEPROM_PROTOCOL onwards.
+ * @return true if the checksum of the image matches and the constants are usable.
+ */
+bool caliPile::decodeCalibration(const uint8_t *eeprom) {
+    CHECKSUM = eepromWord(eeprom, EEPROM_CHECKSUM);
+    lookup = eeprom[EEPROM_LOOKUPNUM - EEPROM_PROTOCOL];
+    PTAT25 = eepromWord(eeprom, EEPROM_PTAT25);
+    M = eepromWord(eeprom, EEPROM_M);
     M /= 100;
-    readRegisters(SENSOR_ADDRESS, EEPROM_U0, 2, &tempData[0]);
-    U0 = ((uint16_t) tempData[0] << 8) | tempData[1];
+    U0 = eepromWord(eeprom, EEPROM_U0);
     U0 += 32768;
-    readRegisters(SENSOR_ADDRESS, EEPROM_UOUT1, 2, &tempData[0]);
-    UOUT1 = ((uint16_t) tempData[0] << 8) | tempData[1];
+    UOUT1 = eepromWord(eeprom, EEPROM_UOUT1);
     UOUT1 *= 2;
-    TOBJ1 = readRegister(SENSOR_ADDRESS, EEPROM_TOBJ1);
-    readRegisters(SENSOR_ADDRESS, EEPROM_CHECKSUM, 2, &tempData[0]);
-    CHECKSUM = ((uint16_t) tempData[0] << 8) | tempData[1];
-    writeRegister(SENSOR_ADDRESS, EEPROM_CONTROL, 0x00);
+    TOBJ1 = eeprom[EEPROM_TOBJ1 - EEPROM_PROTOCOL];
+    // Derived from the new constants on first use
+    k = 0.0f;
+    variantK = 0.0f;
+
+    // The checksum is the sum of all EEPROM cells except the two checksum cells
+    uint16_t sum = 0;
+    uint8_t bits = 0;
+    for (uint8_t i = 0; i < EEPROM_LENGTH; i++) {
+        if (i != EEPROM_CHECKSUM - EEPROM_PROTOCOL && i != EEPROM_CHECKSUM + 1 - EEPROM_PROTOCOL) {
+            sum += eeprom[i];
+        }
+        bits |= eeprom[i];
+    }
+    return sum == CHECKSUM && bits != 0 && M != 0;
+}
+
+/**
+ * @brief Starts the call and reload command without blocking.
+ * 
+ * The general call is sent on the next poll(), which then reports ASYNC_BUSY
+ * until the sensor's 10 ms reload time has passed. The reload discards the
+ * configuration registers of every sensor on the bus, so each instance on
+ * the same caliPileBus marks the registers known to its shadow copy changed
+ * and its next flushConfig() writes them again.
+ * 
+ * @return false if another operation is still in progress.
+ */
+bool caliPile::beginActivate() {
+    return beginAsync(ASYNC_ACTIVATE);
+}
+
+/**
+ * @brief Starts loading the calibration without blocking.
+ * 
+ * Takes three poll() calls: EEPROM access on, image burst read and decode,
+ * EEPROM access off. isCalibrationValid() tells the result.
+ * 
+ * @return false if another operation is still in progress.
+ */
+bool caliPile::beginCalibration() {
+    return beginAsync(ASYNC_CALIBRATION);
+}
 
-    k = ( (float) (UOUT1 - U0) )/(powf((float)(TOBJ1 + 273.15f), lookUpNumber) - powf(25.0f + 273.15f, lookUpNumber) );
+/**
+ * @brief Starts the initMotion() configuration without blocking.
+ * 
+ * Issues one register access per poll() call: a configuration read if
+ * SRC_SELECT is not known yet, then one write per dirty register run. A
+ * failed read ends the operation with ASYNC_ERROR before anything is
+ * written; a failed write does too, and the settings stay pending in the
+ * shadow copy for the next flushConfig() or beginMotion().
+ * 
+ * @return false if another operation is still in progress.
+ */
+bool caliPile::beginMotion(uint8_t LPTime1, uint8_t LPTime2, uint8_t tempSource, uint8_t cycleTime) {
+    if (!beginAsync(ASYNC_MOTION)) {
+        return false;
+    }
+    asyncArgs[0] = LPTime1;
+    asyncArgs[1] = LPTime2;
+    asyncArgs[2] = tempSource;
+    asyncArgs[3] = cycleTime;
+    return true;
+}
 
+/**
+ * @brief Starts a snapshot read without blocking.
+ * 
+ * The result block is read on the next poll() call.
+ * 
+ * @param snapshot The snapshot to be filled. It has to stay valid until the operation is done.
+ * @return false if another operation is still in progress.
+ */
+bool caliPile::beginSnapshot(caliPileSnapshot &snapshot) {
+    if (!beginAsync(ASYNC_SNAPSHOT)) {
+        return false;
+    }
+    asyncSnapshot = &snapshot;
+    return true;
+}
+
+/**
+ * @brief Registers a function to be called when an operation finishes.
+ * 
+ * It is also called when poll() gives an operation up with ASYNC_ERROR.
+ * 
+ * @param callback The function to call, or NULL for none.
+ */
+void caliPile::onComplete(caliPileCallback callback) {
+    asyncCallback = callback;
+}
+
+/**
+ * @brief Tells whether an operation is in progress.
+ * 
+ * @return true until the operation started with one of the begin functions is done.
+ */
+bool caliPile::isBusy() const {
+    return asyncOperation != ASYNC_NONE;
+}
+
+/**
+ * @brief Tells whether the last calibration load found a matching checksum.
+ * 
+ * @return true if the EEPROM image was read and passed decodeCalibration(),
+ *         or loadCalibration() found the stored checksum on the sensor.
+ */
+bool caliPile::isCalibrationValid() const {
+    return calibrationValid;
+}
+
+/**
+ * @brief Advances the operation in progress.
+ * 
+ * Call this from loop(). Each call issues at most one bus transaction and
+ * never waits, so several sensors can be driven side by side while the
+ * application keeps running.
+ * 
+ * @return ASYNC_IDLE if nothing is in progress, ASYNC_BUSY while steps remain,
+ *         ASYNC_DONE on the call that finishes the operation, ASYNC_ERROR on
+ *         the call that gives it up after a failed access (see lastError()).
+ */
+uint8_t caliPile::poll() {
+    CALIPILE_PROFILE(STAT_POLL);
+    uint8_t operation = asyncOperation;
+    bool done = false;
+    bool failed = false;
+    switch (operation) {
+    case ASYNC_NONE:
+        return ASYNC_IDLE;
+
+    case ASYNC_ACTIVATE:
+        if (asyncStep == 0) {
+            writeRegister(0x00, 0x04, 0x00); // Call and reload command
+            // Every sensor on the bus reloads; each instance rewrites its configuration
+            bus->noteReload();
+            asyncStart = millis();
+        } else {
+            done = millis() - asyncStart >= RELOAD_MS;
+        }
+        break;
+
+    case ASYNC_CALIBRATION:
+        if (asyncStep == 0) {
+            writeRegister(deviceAddress, EEPROM_CONTROL, 0x80);
+        } else if (asyncStep == 1) {
+            uint8_t eeprom[EEPROM_LENGTH];
+            memset(eeprom, 0, sizeof(eeprom));
+            // A failed read leaves zeros, which must not pass as a calibration
+            calibrationValid = readRegisters(deviceAddress, EEPROM_PROTOCOL, EEPROM_LENGTH, &eeprom[0]) == BUS_OK
+                    && decodeCalibration(&eeprom[0]);
+        } else {
+            writeRegister(deviceAddress, EEPROM_CONTROL, 0x00);
+            done = true;
+        }
+        break;
+
+    case ASYNC_MOTION:
+        if (asyncStep == 0 && !isConfigKnown(SRC_SELECT)) {
+            syncConfig();
+            break;
+        }
+        if (!isConfigKnown(SRC_SELECT)) {
+            // The read failed; SRC_SELECT must not be built from a guess
+            failed = true;
+            break;
+        }
+        if (asyncStep <= 1) {
+            stageMotion(asyncArgs[0], asyncArgs[1], asyncArgs[2], asyncArgs[3]);
+            asyncStep = 1;
+        }
+        if (!flushConfigStep() && configDirty != 0) {
+            // The changes stay pending for the next flush
+            failed = true;
+        }
+        done = configDirty == 0;
+        break;
+
+    case ASYNC_SNAPSHOT:
+        readSnapshot(*asyncSnapshot);
+        done = true;
+        break;
+    }
+
+    if (!done && !failed) {
+        // Saturate: waiting steps may poll far more than 255 times on a fast host
+        if (asyncStep < 0xFF) {
+            asyncStep++;
+        }
+        return ASYNC_BUSY;
+    }
+    asyncOperation = ASYNC_NONE;
+    if (asyncCallback != NULL) {
+        asyncCallback(*this, operation);
+    }
+    return failed ? ASYNC_ERROR : ASYNC_DONE;
+}
+
+/**
+ * @brief Claims the state machine for a new operation.
+ */
+bool caliPile::beginAsync(uint8_t operation) {
+    if (asyncOperation != ASYNC_NONE) {
+        return false;
+    }
+    asyncOperation = operation;
+    asyncStep = 0;
+    return true;
+}
+
+/**
+ * @brief Runs the operation in progress to completion.
+ */
+void caliPile::finishAsync() {
+    while (poll() == ASYNC_BUSY) {
+    }
+}
+
+/**
+ * @brief Returns the calibration of this sensor for storage.
+ * 
+ * Save the result in non-volatile or retained memory after TempCalculations()
+ * and hand it to loadCalibration() on the next boot to skip the EEPROM read.
+ * 
+ * @return The calibration constants, keyed by address and EEPROM checksum.
+ */
+caliPileCalibration caliPile::calibration() const {
+    caliPileCalibration cal;
+    cal.address = deviceAddress;
+    cal.lookup = lookup;
+    cal.checksum = CHECKSUM;
+    cal.PTAT25 = PTAT25;
+    cal.M = M;
+    cal.U0 = U0;
+    cal.UOUT1 = UOUT1;
+    cal.TOBJ1 = TOBJ1;
+    cal.k = conversionK();
+    return cal;
+}
+
+/**
+ * @brief Restores a calibration saved with calibration().
+ * 
+ * Instead of the whole EEPROM image only the two checksum cells are read,
+ * with EEPROM access enabled around the read. The calibration is rejected
+ * if it was taken from a sensor at another address, was never filled in or
+ * its checksum differs from the sensor's, e.g. because the part was
+ * replaced; read it with TempCalculations() then.
+ * 
+ * @param cal The stored calibration.
+ * @return true if the calibration was applied; isCalibrationValid() then
+ *         reports true as well.
+ */
+bool caliPile::loadCalibration(const caliPileCalibration &cal) {
+    finishAsync();
+    if (cal.address != deviceAddress || cal.M == 0 || !(cal.k != 0.0f)) {
+        return false;
+    }
+    uint8_t checksum[2] = {0, 0};
+    writeRegister(deviceAddress, EEPROM_CONTROL, 0x80);
+    uint8_t error = readRegisters(deviceAddress, EEPROM_CHECKSUM, 2, &checksum[0]);
+    writeRegister(deviceAddress, EEPROM_CONTROL, 0x00);
+    if (error != BUS_OK || (uint16_t) (checksum[0] << 8 | checksum[1]) != cal.checksum) {
+        busError = error;
+        return false;
+    }
+    lookup = cal.lookup;
+    CHECKSUM = cal.checksum;
+    PTAT25 = cal.PTAT25;
+    M = cal.M;
+    U0 = cal.U0;
+    UOUT1 = cal.UOUT1;
+    TOBJ1 = cal.TOBJ1;
+    k = cal.k;
+    variantK = 0.0f;
+    calibrationValid = true;
+    return true;
 }
 
 /**
@@ -108,19 +539,25 @@ void caliPile::TempCalculations() {
  * This function initializes the temperature threshold settings of the sensor
  * by configuring the necessary registers with the provided threshold value.
  * It writes the threshold value to the TPOT_THR register, sets the higher byte
- * to 0x00, sets the temperature source selection bit, and reads the threshold 
- * value back from the sensor registers.
+ * to 0x00 and sets the TPOT direction bit in SRC_SELECT, all through the
+ * configuration shadow copy.
+ * 
+ * If SRC_SELECT cannot be read nothing is written; lastError() tells why.
  * 
  * @param Tcounts The threshold value to be set in the TPOT_THR register.
  */
 void caliPile::initTPotThreshHold(uint16_t Tcounts) {
-    uint8_t rawData[2] = {0, 0};
-    writeRegister(SENSOR_ADDRESS, TPOT_THR, Tcounts);
-    writeRegister(SENSOR_ADDRESS, (TPOT_THR + 1), 0x00);
-    uint8_t temp = readRegister(SENSOR_ADDRESS, SRC_SELECT);
-    writeRegister(SENSOR_ADDRESS, SRC_SELECT, temp | 0x10);
-    readRegisters(SENSOR_ADDRESS, TPOT_THR, 2, &rawData[0]);
-    uint16_t TPOTTHR = ((uint16_t) rawData[0] << 8) | rawData[1];
+    CALIPILE_PROFILE(STAT_TPOT_THRESHOLD);
+    if (!isConfigKnown(SRC_SELECT)) {
+        syncConfig();
+        if (!isConfigKnown(SRC_SELECT)) {
+            return;
+        }
+    }
+    setConfig(TPOT_THR, Tcounts);
+    setConfig(TPOT_THR + 1, 0x00);
+    setConfig(SRC_SELECT, configValue(SRC_SELECT) | 0x10);
+    flushConfig();
 }
 
 /**
@@ -131,7 +568,9 @@ void caliPile::initTPotThreshHold(uint16_t Tcounts) {
  * @param Tcounts The temperature motion threshold value to be set in the sensor.
  */
 void caliPile::initTpMotionThreshHold(uint16_t Tcounts) {
-    writeRegister(SENSOR_ADDRESS, TP_MOT_THLD, Tcounts);
+    CALIPILE_PROFILE(STAT_MOTION_THRESHOLD);
+    setConfig(TP_MOT_THLD, Tcounts);
+    flushConfig();
 }
 
 /**
@@ -142,7 +581,237 @@ void caliPile::initTpMotionThreshHold(uint16_t Tcounts) {
  * @param Tcounts The temperature presence threshold value to be set in the sensor.
  */
 void caliPile::initTpPresenceThreshHold(uint16_t Tcounts) {
-    writeRegister(SENSOR_ADDRESS, TP_PRES_THLD, Tcounts);
+    CALIPILE_PROFILE(STAT_PRESENCE_THRESHOLD);
+    setConfig(TP_PRES_THLD, Tcounts);
+    flushConfig();
+}
+
+/**
+ * @brief Sets up periodic acquisition with the on-chip timer interrupt.
+ * 
+ * Programs TMR_INT for an interrupt every (1 + TMR_INT) * 30 ms and sets
+ * INT_TIMER in INT_MASK, so the INT pin falls once per period right after
+ * a conversion result became valid. Pick a multiple of the cycle time so
+ * every read sees a new result. Read with readTimedSnapshot().
+ * 
+ * @param periodMs The sampling period, 30 to 7680 ms. 0 masks the timer interrupt again.
+ * @return The period programmed, rounded down to a multiple of 30 ms, or 0,
+ *         also if INT_MASK could not be read (see lastError()).
+ */
+uint16_t caliPile::initTimer(uint16_t periodMs) {
+    CALIPILE_PROFILE(STAT_INIT_TIMER);
+    if (!isConfigKnown(INT_MASK)) {
+        syncConfig();
+        if (!isConfigKnown(INT_MASK)) {
+            return 0;
+        }
+    }
+    if (periodMs == 0) {
+        setConfig(INT_MASK, configValue(INT_MASK) & ~INT_TIMER);
+        flushConfig();
+        return 0;
+    }
+    uint16_t periods = periodMs / 30;
+    if (periods < 1) {
+        periods = 1;
+    } else if (periods > 256) {
+        periods = 256;
+    }
+    setConfig(TMR_INT, periods - 1);
+    setConfig(INT_MASK, configValue(INT_MASK) | INT_TIMER);
+    flushConfig();
+    return periods * 30;
+}
+
+/**
+ * @brief Reads the result block once per assertion of the INT pin.
+ * 
+ * Call from loop() as often as convenient. While the INT pin is high it
+ * returns at once without bus traffic. When it is low the result block is
+ * read in one burst, which also clears INTERRUPT_STATUS and releases the
+ * pin, so every timer period is read exactly once.
+ * 
+ * @param snapshot Receives the result block when a read was made.
+ * @return INTERRUPT_STATUS of the read (test INT_TIMER for a new period), or
+ *         0 if the INT pin was not asserted and nothing was read.
+ */
+uint8_t caliPile::readTimedSnapshot(caliPileSnapshot &snapshot) {
+    if (digitalRead(interruptPin) != LOW) {
+        return 0;
+    }
+    CALIPILE_PROFILE(STAT_READ_TIMED_SNAPSHOT);
+    readSnapshot(snapshot);
+    return snapshot.interruptStatus();
+}
+
+/**
+ * @brief Reads all configuration registers into the shadow copy.
+ * 
+ * SLP12..TPOT_THR are read in one burst. Registers with a pending change
+ * keep their new value. Registers the read did not deliver stay unknown.
+ */
+void caliPile::syncConfig() {
+    CALIPILE_PROFILE(STAT_SYNC_CONFIG);
+    checkReload();
+    uint8_t rawData[CONFIG_LENGTH];
+    readRegisters(deviceAddress, SLP12, CONFIG_LENGTH, &rawData[0]);
+    // Only the bytes that arrived are known; a failed read learns nothing
+    for (uint8_t i = 0; i < readCount; i++) {
+        if (!(configDirty & (1 << i))) {
+            config[i] = rawData[i];
+        }
+        configKnown |= 1 << i;
+    }
+    if (isConfigKnown(SRC_SELECT)) {
+        cycle = config[SRC_SELECT - SLP12] & 0x03;
+    }
+}
+
+/**
+ * @brief Forgets the shadow copy, e.g. after the sensor lost power.
+ * 
+ * Pending changes are dropped; the next setter reads the registers again.
+ */
+void caliPile::invalidateConfig() {
+    configKnown = 0;
+    configDirty = 0;
+}
+
+/**
+ * @brief Tells whether the value of a configuration register is known.
+ * 
+ * @param reg A register between SLP12 and TPOT_THR + 1.
+ * @return true if the shadow copy holds the register's value.
+ */
+bool caliPile::isConfigKnown(uint8_t reg) const {
+    return configKnown & (1 << (reg - SLP12));
+}
+
+/**
+ * @brief Returns the shadow copy of a configuration register.
+ * 
+ * @param reg A register between SLP12 and TPOT_THR + 1.
+ * @return The last value read or set, pending changes included.
+ */
+uint8_t caliPile::configValue(uint8_t reg) const {
+    return config[reg - SLP12];
+}
+
+/**
+ * @brief Changes a configuration register in the shadow copy.
+ * 
+ * Nothing is sent until flushConfig(), or until restoreConfig() after a
+ * reload. Setting a register to the value it already holds does not mark
+ * it for writing.
+ * 
+ * @param reg A register between SLP12 and TPOT_THR + 1.
+ * @param value The new register value.
+ */
+void caliPile::setConfig(uint8_t reg, uint8_t value) {
+    checkReload();
+    uint16_t bit = 1 << (reg - SLP12);
+    if ((configKnown & bit) && config[reg - SLP12] == value) {
+        return;
+    }
+    config[reg - SLP12] = value;
+    configKnown |= bit;
+    configDirty |= bit;
+    if (reg == SRC_SELECT) {
+        cycle = value & 0x03;
+    }
+}
+
+/**
+ * @brief Writes all changed configuration registers to the sensor.
+ * 
+ * Changed registers are written as contiguous multi-byte writes. Unchanged
+ * registers whose value is known are rewritten when that joins two runs, so
+ * a full reconfiguration usually costs a single transaction. The flush stops
+ * at the first failed write; lastError() tells why and the remaining
+ * changes stay pending.
+ */
+void caliPile::flushConfig() {
+    CALIPILE_PROFILE(STAT_FLUSH_CONFIG);
+    while (flushConfigStep()) {
+    }
+}
+
+/**
+ * @brief Writes the first run of changed configuration registers.
+ * 
+ * The registers stay marked changed until the sensor acknowledged them, so
+ * a failed write, e.g. within the 10 ms after a reload, is sent again by
+ * the next flush.
+ * 
+ * @return false if there was nothing to write or the write failed (see lastError()).
+ */
+bool caliPile::flushConfigStep() {
+    checkReload();
+    uint8_t first = 0;
+    while (first < CONFIG_LENGTH && !(configDirty & (1 << first))) {
+        first++;
+    }
+    if (first == CONFIG_LENGTH) {
+        return false;
+    }
+    uint8_t last = first;
+    for (uint8_t i = first + 1; i < CONFIG_LENGTH && (configKnown & (1 << i)); i++) {
+        if (configDirty & (1 << i)) {
+            last = i;
+        }
+    }
+    if (writeRegisters(deviceAddress, SLP12 + first, last - first + 1, &config[first]) != BUS_OK) {
+        return false;
+    }
+    for (uint8_t i = first; i <= last; i++) {
+        configDirty &= ~(1 << i);
+    }
+    return true;
+}
+
+/**
+ * @brief Catches up with general call reloads sent by any instance on the bus.
+ * 
+ * The sensor lost its configuration, so the registers known to the shadow
+ * copy are marked changed and restoreConfig() writes them back.
+ */
+void caliPile::checkReload() {
+    if (bus->reloadCount() != reloadsSeen) {
+        reloadsSeen = bus->reloadCount();
+        configDirty |= configKnown;
+        restorePending = configKnown != 0;
+    }
+}
+
+/**
+ * @brief Writes the shadow copy back after a reload.
+ * 
+ * Runs before every read, so a sensor that is only sampled gets its
+ * interrupt mask and timer back without a flushConfig() from the
+ * application. Nothing is sent until RELOAD_MS after the reload; a failed
+ * write is retried by the next read. Changes that were
+ * pending at the reload are written with the restored registers.
+ */
+void caliPile::restoreConfig() {
+    if (recovering || millis() - bus->lastReload() < RELOAD_MS) {
+        return;
+    }
+    while (flushConfigStep()) {
+    }
+    restorePending = configDirty != 0;
+}
+
+/**
+ * @brief Stages the initMotion() settings in the shadow copy.
+ */
+void caliPile::stageMotion(uint8_t LPTime1, uint8_t LPTime2, uint8_t tempSource, uint8_t cycleTime) {
+    setConfig(INT_MASK, 0x1C);
+    setConfig(SLP12, LPTime2 << 4 | LPTime1);
+    // Bits [3:0] are replaced; the upper bits belong to initTPotThreshHold()
+    uint8_t sourceSelect = (configValue(SRC_SELECT) & ~0x0F) | tempSource << 2 | cycleTime;
+    setConfig(SRC_SELECT, sourceSelect);
+    setConfig(TP_PRES_THLD, 0x22); // presence threshold
+    setConfig(TP_MOT_THLD, 0x0A); // motion threshold
 }
 
 /**
@@ -157,11 +826,10 @@ void caliPile::initTpPresenceThreshHold(uint16_t Tcounts) {
  * The temperature value is returned as a floating-point value in degrees Celsius.
  */
 float caliPile::getAmbientTemp() {
+    CALIPILE_PROFILE(STAT_AMBIENT_TEMP);
     uint8_t rawData[2] = {0, 0};
-    readRegisters(SENSOR_ADDRESS, TPAMBIENT, 2, &rawData[0]);
-    uint16_t TPAmbient = ((uint16_t)(rawData[0] & 0x7F) << 8) | rawData[1];
- 
-    return TPAmbient;
+    readRegisters(deviceAddress, TPAMBIENT, 2, &rawData[0]);
+    return decodeAmbientTemp(&rawData[0]);
 }
 
 /**
@@ -177,15 +845,15 @@ float caliPile::getAmbientTemp() {
  * @return The object temperature reading from the sensor.
  */
 uint32_t caliPile::getObjectTemp() {
+    CALIPILE_PROFILE(STAT_OBJECT_TEMP);
     
     uint8_t rawData[3] = {0, 0, 0};
-    readRegisters(SENSOR_ADDRESS, TPOBJECT, 3, &rawData[0]);
-    uint32_t TPObject = ((uint32_t) ( (uint32_t)rawData[0] << 24) | ( (uint32_t)rawData[1] << 16) | ( (uint32_t)rawData[2] & 0x80) << 8) >> 15;
-
-    return TPObject;
+    readRegisters(deviceAddress, TPOBJECT, 3, &rawData[0]);
+    return decodeObjectTemp(&rawData[0]);
 }
 
 float caliPile::convertToCelcius(float temp_val ) {
+    CALIPILE_PROFILE(STAT_CONVERT_CELSIUS);
     return (temp_val - 273.15);
 }
 
@@ -202,11 +870,10 @@ float caliPile::convertToCelcius(float temp_val ) {
  * @return The object temperature reading in low power mode 1 from the sensor.
  */
 uint32_t caliPile::getObjectTempLP1() {
+    CALIPILE_PROFILE(STAT_OBJECT_TEMP_LP1);
     uint8_t rawData[3] = {0, 0, 0};
-    readRegisters(SENSOR_ADDRESS, TPOBJLP1, 3, &rawData[0]);
-    uint32_t temp = (((uint32_t) rawData[0] << 16) | ((uint32_t) rawData[1] << 8) | ( (uint32_t)rawData[2] & 0xF0) ) >> 4;
-    temp /= 8;
-    return temp;
+    readRegisters(deviceAddress, TPOBJLP1, 3, &rawData[0]);
+    return decodeObjectTempLP1(&rawData[0]);
 }
 
 /**
@@ -221,11 +888,10 @@ uint32_t caliPile::getObjectTempLP1() {
  * @return The object temperature reading in low power mode 2 from the sensor.
  */
 uint32_t caliPile::getObjectTempLP2() {
+    CALIPILE_PROFILE(STAT_OBJECT_TEMP_LP2);
     uint8_t rawData[3] = {0, 0, 0};
-    readRegisters(SENSOR_ADDRESS, TPOBJLP2, 3, &rawData[0]);
-    uint32_t temp = ((uint32_t) (rawData[0] & 0x0F) << 16) | ((uint32_t) rawData[1] << 8) | rawData[2];
-    temp /= 8;
-    return temp;
+    readRegisters(deviceAddress, TPOBJLP2, 3, &rawData[0]);
+    return decodeObjectTempLP2(&rawData[0]);
 }
 
 /**
@@ -240,11 +906,10 @@ uint32_t caliPile::getObjectTempLP2() {
  * @return The ambient temperature reading in low power mode 3 from the sensor.
  */
 uint16_t caliPile::getAmbientTempLP3() {
+    CALIPILE_PROFILE(STAT_AMBIENT_TEMP_LP3);
     uint8_t rawData[2] = {0, 0};
-    readRegisters(SENSOR_ADDRESS, TPAMBLP3, 3, &rawData[0]);
-    uint16_t temp = ((uint16_t) rawData[0] << 8) | rawData[1];
-    temp /= 2;
-    return temp;
+    readRegisters(deviceAddress, TPAMBLP3, 2, &rawData[0]);
+    return decodeAmbientTempLP3(&rawData[0]);
 }
 
 /**
@@ -259,11 +924,10 @@ uint16_t caliPile::getAmbientTempLP3() {
  * @return The frozen object temperature reading in low power mode 2 from the sensor.
  */
 uint32_t caliPile::getObjectTempLP2Frozen() {
+    CALIPILE_PROFILE(STAT_OBJECT_TEMP_LP2_FROZEN);
     uint8_t rawData[3] = {0, 0, 0};
-    readRegisters(SENSOR_ADDRESS, TPOBJLP2_FRZN, 3, &rawData[0]);
-    uint32_t temp = ((uint32_t) rawData[0] << 16) | ((uint32_t) rawData[1] << 8) | rawData[2];
-    temp /= 128;
-    return temp;
+    readRegisters(deviceAddress, TPOBJLP2_FRZN, 3, &rawData[0]);
+    return decodeObjectTempLP2Frozen(&rawData[0]);
 }
 
 /**
@@ -276,7 +940,8 @@ uint32_t caliPile::getObjectTempLP2Frozen() {
  * @return The presence status from the sensor.
  */
 uint8_t caliPile::getPresenceStat() {
-    uint8_t temp = readRegister(SENSOR_ADDRESS, TPPRESENCE);
+    CALIPILE_PROFILE(STAT_PRESENCE);
+    uint8_t temp = readRegister(deviceAddress, TPPRESENCE);
     return temp;
 }
 
@@ -290,7 +955,8 @@ uint8_t caliPile::getPresenceStat() {
  * @return The motion status from the sensor.
  */
 uint8_t caliPile::getMotionStat() {
-    uint8_t temp = readRegister(SENSOR_ADDRESS, TPMOTION);
+    CALIPILE_PROFILE(STAT_MOTION);
+    uint8_t temp = readRegister(deviceAddress, TPMOTION);
     return temp;
 }
 
@@ -304,10 +970,93 @@ uint8_t caliPile::getMotionStat() {
  * @return The ambient shock status from the sensor.
  */
 uint8_t caliPile::getAmbientShockStat() {
-    uint8_t temp = readRegister(SENSOR_ADDRESS, TPAMB_SHOCK);
+    CALIPILE_PROFILE(STAT_AMBIENT_SHOCK);
+    uint8_t temp = readRegister(deviceAddress, TPAMB_SHOCK);
     return temp;
 }
 
+/**
+ * @brief Reads the whole result block in a single I2C transaction.
+ *
+ * This function reads the registers from TPOBJECT through CHIP_STATUS with one
+ * auto-increment burst and stores them in the given snapshot. All fields are
+ * therefore taken from the same conversion cycle, and a full sample costs one
+ * bus transaction instead of one per getter.
+ *
+ * @note INTERRUPT_STATUS is part of the block, so reading a snapshot clears the
+ *       latched interrupt flags just like interruptStatus() does.
+ *
+ * @param snapshot The snapshot to be filled with the register contents.
+ * @return BUS_OK or the caliPileError of the read; bytes that did not
+ *         arrive are 0 in the snapshot (see readRegisters()).
+ */
+uint8_t caliPile::readSnapshot(caliPileSnapshot &snapshot) {
+    CALIPILE_PROFILE(STAT_READ_SNAPSHOT);
+    return readRegisters(deviceAddress, TPOBJECT, SNAPSHOT_LENGTH, &snapshot.raw[0]);
+}
+
+uint32_t caliPileSnapshot::objectTemp() const {
+    return decodeObjectTemp(&raw[TPOBJECT - TPOBJECT]);
+}
+
+uint16_t caliPileSnapshot::ambientTemp() const {
+    return decodeAmbientTemp(&raw[TPAMBIENT - TPOBJECT]);
+}
+
+uint32_t caliPileSnapshot::objectTempLP1() const {
+    return decodeObjectTempLP1(&raw[TPOBJLP1 - TPOBJECT]);
+}
+
+uint32_t caliPileSnapshot::objectTempLP2() const {
+    return decodeObjectTempLP2(&raw[TPOBJLP2 - TPOBJECT]);
+}
+
+/**
+ * @brief Returns the 20-bit TPOBJLP1 field before the division by 8.
+ * 
+ * @return 8 times objectTempLP1() plus the three bits it drops.
+ */
+uint32_t caliPileSnapshot::objectTempLP1Raw() const {
+    return decodeObjectTempLP1Raw(&raw[TPOBJLP1 - TPOBJECT]);
+}
+
+/**
+ * @brief Returns the 20-bit TPOBJLP2 field before the division by 8.
+ * 
+ * @return 8 times objectTempLP2() plus the three bits it drops.
+ */
+uint32_t caliPileSnapshot::objectTempLP2Raw() const {
+    return decodeObjectTempLP2Raw(&raw[TPOBJLP2 - TPOBJECT]);
+}
+
+uint16_t caliPileSnapshot::ambientTempLP3() const {
+    return decodeAmbientTempLP3(&raw[TPAMBLP3 - TPOBJECT]);
+}
+
+uint32_t caliPileSnapshot::objectTempLP2Frozen() const {
+    return decodeObjectTempLP2Frozen(&raw[TPOBJLP2_FRZN - TPOBJECT]);
+}
+
+uint8_t caliPileSnapshot::presenceStat() const {
+    return raw[TPPRESENCE - TPOBJECT];
+}
+
+uint8_t caliPileSnapshot::motionStat() const {
+    return raw[TPMOTION - TPOBJECT];
+}
+
+uint8_t caliPileSnapshot::ambientShockStat() const {
+    return raw[TPAMB_SHOCK - TPOBJECT];
+}
+
+uint8_t caliPileSnapshot::interruptStatus() const {
+    return raw[INTERRUPT_STATUS - TPOBJECT];
+}
+
+uint8_t caliPileSnapshot::chipStatus() const {
+    return raw[CHIP_STATUS - TPOBJECT];
+}
+
 /**
  * @brief Calculates the ambient temperature from the raw ambient temperature reading.
  * 
@@ -320,6 +1069,7 @@ uint8_t caliPile::getAmbientShockStat() {
  * @return The calculated ambient temperature in degrees Kelvin.
  */
 float caliPile::calcAmbientTemp(uint16_t ambientTemp) {
+    CALIPILE_PROFILE(STAT_CALC_AMBIENT);
     float temp = 298.15f + ((float)ambientTemp - (float)PTAT25) * (1.0f / (float)M);
     return temp;
 }
@@ -329,9 +1079,10 @@ float caliPile::calcAmbientTemp(uint16_t ambientTemp) {
  * 
  * This function calculates the object temperature from the raw object temperature reading and ambient temperature.
  * It uses the U0 and k constants, as well as mathematical formulas, to perform the calculation.
- * It first calculates `temp0` by raising the ambient temperature to the power of 3.8.
+ * It first calculates `temp0` by raising the ambient temperature to the power of the variant's exponent
+ * (3.8 for TPiS 1S, 4.2 for TPiS 1T, as detected from EEPROM_LOOKUPNUM by TempCalculations()).
  * Then, it calculates `temp1` by subtracting the U0 constant from the raw object temperature and dividing by the k constant.
- * Next, it calculates `temp2` by adding `temp0` and `temp1`, and raising the result to the power of 0.2631578947.
+ * Next, it raises the sum of `temp0` and `temp1` to the reciprocal of the exponent.
  * The resulting temperature is returned as a floating-point value.
  * 
  * @param objectTemp The raw object temperature reading.
@@ -339,10 +1090,79 @@ float caliPile::calcAmbientTemp(uint16_t ambientTemp) {
  * @return The calculated object temperature.
  */
 float caliPile::calcObjectTemp(uint32_t objectTemp, float ambientTemp) {
-    float temp0 = powf(ambientTemp, lookUpNumber);
-    float temp1 = (((float) objectTemp) - ((float) U0)) / k ;
-    float result_temp = powf((temp0 + temp1), 1.0 / lookUpNumber);
-    return result_temp;
+    CALIPILE_PROFILE(STAT_CALC_OBJECT);
+    if (isTPiS1S()) {
+        return calcObjectTemp<caliPileTPiS1S>(objectTemp, ambientTemp);
+    }
+    return calcObjectTemp<caliPileTPiS1T>(objectTemp, ambientTemp);
+}
+
+/**
+ * @brief Returns the constant k of the object temperature formula.
+ * 
+ * k = (UOUT1 - U0) / ((TOBJ1 + 273.15)^n - 298.15^n) takes two powf()
+ * calls. It is derived here on first use and kept until new constants are
+ * loaded, so code that only loads the calibration and converts with
+ * caliPileFixedPoint does not link powf().
+ * 
+ * @return k for the detected variant's exponent n.
+ */
+float caliPile::conversionK() const {
+    if (!(k != 0.0f)) {
+        k = deriveK(exponent());
+    }
+    return k;
+}
+
+/**
+ * @brief Returns k for a given exponent, e.g. of a variant fixed at compile time.
+ * 
+ * The detected variant's exponent gives conversionK(). For the other one k
+ * is derived once and kept next to it until new constants are loaded, so
+ * calcObjectTemp<Variant>() never divides by a k of the wrong exponent.
+ * 
+ * @param n The exponent, e.g. caliPileTPiS1T::exponent().
+ * @return k for the exponent n.
+ */
+float caliPile::conversionK(float n) const {
+    if (n == exponent()) {
+        return conversionK();
+    }
+    if (!(variantK != 0.0f) || variantExponent != n) {
+        variantK = deriveK(n);
+        variantExponent = n;
+    }
+    return variantK;
+}
+
+/**
+ * @brief Computes k = (UOUT1 - U0) / ((TOBJ1 + 273.15)^n - 298.15^n).
+ * 
+ * @param n The exponent.
+ * @return k for the loaded constants.
+ */
+float caliPile::deriveK(float n) const {
+    return ( (float) (UOUT1 - U0) )/(powf((float)(TOBJ1 + 273.15f), n) - powf(25.0f + 273.15f, n) );
+}
+
+/**
+ * @brief Tells whether the EEPROM identifies the sensor as a TPiS 1S.
+ * 
+ * Until the calibration is read the sensor is assumed to be a TPiS 1T.
+ * 
+ * @return true if LOOKUP# is LOOKUP_TPIS_1S.
+ */
+bool caliPile::isTPiS1S() const {
+    return lookup == LOOKUP_TPIS_1S;
+}
+
+/**
+ * @brief Returns the exponent of the detected sensor variant.
+ * 
+ * @return 3.8 for a TPiS 1S, 4.2 for a TPiS 1T.
+ */
+float caliPile::exponent() const {
+    return isTPiS1S() ? caliPileTPiS1S::exponent() : caliPileTPiS1T::exponent();
 }
 
 /**
@@ -355,14 +1175,41 @@ float caliPile::calcObjectTemp(uint32_t objectTemp, float ambientTemp) {
  * @param address The address of the sensor.
  * @param altAddress The address of the register within the sensor.
  * @param data The data value to be written to the register.
+ * @return BUS_OK or the caliPileError of the access.
  */
-void caliPile::writeRegister(uint8_t address, uint8_t altAddress, uint8_t data) {
+uint8_t caliPile::writeRegister(uint8_t address, uint8_t altAddress, uint8_t data) {
     uint8_t temp[2];
     temp[0] = altAddress;
     temp[1] = data;
-    Wire.beginTransmission(address);
-    Wire.write(&temp[0], 2);
-    Wire.endTransmission();
+    uint32_t start = beginTransfer();
+    uint8_t result = bus->write(address, &temp[0], 2);
+#ifdef CALIPILE_BUS_STATS
+    recordTransaction(2, 0, 0, writeError(result));
+#endif
+    return finishTransfer(writeError(result), start);
+}
+
+/**
+ * @brief Writes consecutive registers of the sensor in one transaction.
+ * 
+ * The register pointer auto-increments after every data byte.
+ * 
+ * @param address The address of the sensor.
+ * @param altAddress The first register to be written.
+ * @param count The number of registers to write, at most CONFIG_LENGTH.
+ * @param data The values to be written.
+ * @return BUS_OK or the caliPileError of the access.
+ */
+uint8_t caliPile::writeRegisters(uint8_t address, uint8_t altAddress, uint8_t count, const uint8_t *data) {
+    uint8_t temp[CONFIG_LENGTH + 1];
+    temp[0] = altAddress;
+    memcpy(&temp[1], data, count);
+    uint32_t start = beginTransfer();
+    uint8_t result = bus->write(address, &temp[0], count + 1);
+#ifdef CALIPILE_BUS_STATS
+    recordTransaction(count + 1, 0, 0, writeError(result));
+#endif
+    return finishTransfer(writeError(result), start);
 }
 
 /**
@@ -370,26 +1217,18 @@ void caliPile::writeRegister(uint8_t address, uint8_t altAddress, uint8_t data)
  * 
  * This function reads data from a register of the sensor specified by the address parameter.
  * It uses the altAddress parameter to specify the address of the register within the device.
- * The function initiates a transmission to the sensor using Wire.beginTransmission(),
- * writes the altAddress to request the data from the specified register using Wire.write(),
- * and ends the transmission using Wire.endTransmission().
- * It then requests one byte of data from the sensor using Wire.requestFrom(),
- * and if data is available, it reads the byte using Wire.read() and stores it in the temp array.
- * Finally, it returns the read data.
+ * The register pointer write and the one-byte read are issued as a single
+ * combined transfer on the instance's bus, joined by a repeated START.
  *
  * @param address The address of the sensor.
  * @param altAddress The address of the register within the sensor.
+ * If the access fails the result is 0 and lastError() tells why.
+ *
  * @return The data read from the specified register.
  */
 uint8_t caliPile::readRegister(uint8_t address, uint8_t altAddress) {
     uint8_t temp[1];
-    Wire.beginTransmission(address);
-    Wire.write(altAddress);
-    Wire.endTransmission();
-    Wire.requestFrom(address, 1);
-    if (Wire.available()) {
-        temp[0] = Wire.read();
-    }
+    readRegisters(address, altAddress, 1, &temp[0]);
     return temp[0];
 }
 
@@ -400,25 +1239,367 @@ uint8_t caliPile::readRegister(uint8_t address, uint8_t altAddress) {
  * It uses the altAddress parameter to specify the starting address of the registers within the device.
  * The count parameter represents the number of registers to read, and the target parameter is a pointer to an array where the read data will be stored.
  * 
- * The function initiates a transmission to the sensor using Wire.beginTransmission(),
- * writes the altAddress to request the data from the specified starting register using Wire.write(),
- * and ends the transmission using Wire.endTransmission().
- * It then requests the specified number of bytes of data from the sensor using Wire.requestFrom(),
- * and for each byte of data available, it reads it using Wire.read() and stores it in the target array.
+ * The register pointer write and the burst read are issued as a single combined
+ * transfer on the instance's bus, joined by a repeated START, so the sensor's
+ * auto-increment walks through consecutive registers.
  * 
  * @param address The address of the sensor.
  * @param altAddress The starting address of the registers within the sensor.
  * @param count The number of registers to read.
  * @param target Pointer to an array where the read data will be stored.
+ *               Bytes that did not arrive are set to 0, never left stale.
+ * @return BUS_OK or the caliPileError of the access.
+ */
+uint8_t caliPile::readRegisters(uint8_t address, uint8_t altAddress, uint8_t count, uint8_t *target) {
+    checkReload();
+    if (restorePending) {
+        restoreConfig();
+    }
+    uint32_t start = beginTransfer();
+    uint8_t received = bus->writeRead(address, altAddress, target, count);
+    uint8_t error = BUS_OK;
+    if (received < count) {
+        memset(&target[received], 0, count - received);
+        error = BUS_SHORT_READ;
+        // Nothing read because the pointer write failed, e.g. no device at the address
+        if (received == 0 && bus->pointerStatus() != 0) {
+            error = writeError(bus->pointerStatus());
+        }
+    }
+#ifdef CALIPILE_BUS_STATS
+    recordTransaction(1, error == BUS_SHORT_READ || error == BUS_OK ? count : 0, received, error);
+#endif
+    readCount = received;
+    return finishTransfer(error, start);
+}
+
+/**
+ * @brief Sets the deadline of every register access.
+ * 
+ * The limit is handed to the bus, which aborts a transfer that holds the
+ * bus longer where the core supports it (AVR, megaAVR, ESP32). An access
+ * that ends late or aborted returns BUS_TIMEOUT and runs the recovery
+ * sequence, so one sample costs at most the deadline plus the recovery.
+ * 
+ * @param timeoutMicros The deadline in microseconds, 0 for none.
+ */
+void caliPile::setBusTimeout(uint32_t timeoutMicros) {
+    busTimeout = timeoutMicros;
+    timeoutApplied = false;
+}
+
+/**
+ * @brief Returns the result of the last register access.
+ * 
+ * @return A caliPileError, BUS_OK if the access succeeded.
+ */
+uint8_t caliPile::lastError() const {
+    return busError;
+}
+
+/**
+ * @brief Prepares one register access.
+ * 
+ * The deadline is handed to the bus on the first access rather than in the
+ * constructor, where the bus object may not be constructed yet.
+ * 
+ * @return The start time of the access, in microseconds.
+ */
+uint32_t caliPile::beginTransfer() {
+    if (!timeoutApplied) {
+        bus->setTimeout(busTimeout);
+        timeoutApplied = true;
+    }
+    return micros();
+}
+
+/**
+ * @brief Checks the deadline of an access and recovers the bus if needed.
+ * 
+ * @param error The result reported by the bus.
+ * @param start The start time returned by beginTransfer().
+ * @return The final caliPileError of the access.
+ */
+uint8_t caliPile::finishTransfer(uint8_t error, uint32_t start) {
+    uint32_t elapsed = micros() - start;
+    if (bus->timedOut() || (busTimeout != 0 && elapsed > busTimeout)) {
+        error = BUS_TIMEOUT;
+    }
+#ifdef CALIPILE_BUS_STATS
+    if (elapsed > stats.maxMicros) {
+        stats.maxMicros = elapsed;
+    }
+    if (error == BUS_TIMEOUT) {
+        stats.timeouts++;
+    }
+#endif
+    if ((error == BUS_TIMEOUT || error == BUS_ERROR) && !recovering) {
+        recoverBus();
+    }
+    busError = error;
+    return error;
+}
+
+/**
+ * @brief Brings a stuck bus and the sensor back to a known state.
+ * 
+ * The bus clocks SCL until the sensor releases SDA and is re-initialized,
+ * then the general call reloads the sensor like activateSensor(). The
+ * sensor needs about 10 ms before it answers again; accesses in that time
+ * fail with BUS_NACK.
+ * 
+ * The general call reaches every CaliPile on the bus, not only this one.
+ * It is recorded on the caliPileBus, and every instance using that bus
+ * object, this one and its siblings (e.g. caliPileArray members), writes
+ * the configuration registers known to its shadow copy back on its first
+ * access after RELOAD_MS, see restoreConfig(). A plain SCL clock-out
+ * without the reload would leave a sensor that lost its state
+ * mid-transfer undefined.
+ */
+void caliPile::recoverBus() {
+    recovering = true;
+    bus->recover();
+    timeoutApplied = false;
+    writeRegister(0x00, 0x04, 0x00); // Call and reload command
+    bus->noteReload();
+    recovering = false;
+#ifdef CALIPILE_BUS_STATS
+    stats.recoveries++;
+#endif
+}
+
+#ifdef CALIPILE_BUS_STATS
+/**
+ * @brief Returns the I2C transactions recorded since the last reset.
+ *
+ * Reset the ledger, call a method and read it back to see what that method
+ * costs on the bus.
+ *
+ * @return The cumulative transaction, byte and modeled bus time counters.
+ */
+const caliPileBusStats &caliPile::busStats() const {
+    return stats;
+}
+
+/**
+ * @brief Clears the I2C transaction ledger.
+ */
+void caliPile::resetBusStats() {
+    stats.transactions = 0;
+    stats.bytes = 0;
+    stats.busMicros = 0;
+    stats.nacks = 0;
+    stats.busErrors = 0;
+    stats.shortReads = 0;
+    stats.timeouts = 0;
+    stats.recoveries = 0;
+    stats.maxMicros = 0;
+}
+
+/**
+ * @brief Sets the bus clock used to model the time of each transaction.
+ *
+ * @param clockHz The SCL frequency of the bus, in Hz.
+ */
+void caliPile::setBusClock(uint32_t clockHz) {
+    busClockHz = clockHz;
+}
+
+/**
+ * @brief Adds one START..STOP frame to the ledger.
+ *
+ * @param writeBytes Number of bytes written after the address byte.
+ * @param readBytes Number of bytes requested after a repeated START, or 0 if
+ *                  there was no read phase (plain write, or the pointer write failed).
+ * @param received Number of bytes received in the read phase.
+ * @param error The caliPileError of the access.
+ */
+void caliPile::recordTransaction(uint8_t writeBytes, uint8_t readBytes, uint8_t received, uint8_t error) {
+    uint32_t bits = 2 + 9UL * (1 + writeBytes);
+    uint32_t bytes = 1 + writeBytes;
+    if (readBytes > 0) {
+        bits += 1 + 9UL * (1 + received);
+        bytes += 1 + received;
+    }
+    if (error == BUS_NACK) {
+        stats.nacks++;
+    } else if (error == BUS_SHORT_READ) {
+        stats.shortReads++;
+    } else if (error != BUS_OK) {
+        stats.busErrors++;
+    }
+    stats.transactions++;
+    stats.bytes += bytes;
+    stats.busMicros += (bits * 1000000UL + busClockHz - 1) / busClockHz;
+}
+#endif
+
+#ifdef CALIPILE_METHOD_STATS
+/**
+ * @brief Returns the timing of the public methods since the last reset.
+ *
+ * The array is owned by the instance and updated in place, so reading it
+ * costs nothing; copy the entries of interest if they must stay consistent.
+ *
+ * @return STAT_METHODS entries, indexed by the STAT_* constants.
+ */
+const caliPileMethodStats *caliPile::methodStats() const {
+    return methods;
+}
+
+/**
+ * @brief Clears the method timing.
+ */
+void caliPile::resetMethodStats() {
+    memset(methods, 0, sizeof(methods));
+}
+
+/**
+ * @brief Returns the name of a timed method, for printing.
+ *
+ * @param method One of the STAT_* constants.
+ * @return The method name, or "?" for an unknown index.
+ */
+const char *caliPile::methodName(uint8_t method) {
+    static const char *const names[STAT_METHODS] = {
+        "activateSensor", "interruptStatus", "initMotion", "TempCalculations", "poll",
+        "syncConfig", "flushConfig", "initTPotThreshHold", "initTpMotionThreshHold",
+        "initTpPresenceThreshHold", "getAmbientTemp", "getObjectTemp", "getObjectTempLP1",
+        "getObjectTempLP2", "getAmbientTempLP3", "getObjectTempLP2Frozen", "getPresenceStat",
+        "getMotionStat", "getAmbientShockStat", "readSnapshot", "convertToCelcius",
+        "calcAmbientTemp", "calcObjectTemp", "initTimer", "readTimedSnapshot"
+    };
+    return method < STAT_METHODS ? names[method] : "?";
+}
+#endif
+
+#ifndef CALIPILE_LINUX
+/**
+ * @brief Constructor for the Wire transport.
+ * 
+ * Pass the SDA and SCL pins of the bus to let recover() free a bus that a
+ * slave holds low; without them recovery only re-initializes the TwoWire.
+ * 
+ * @param wireBus The TwoWire instance the sensor is connected to, e.g. Wire or Wire1.
+ * @param sdaPin The SDA pin of the bus, -1 if unknown.
+ * @param sclPin The SCL pin of the bus, -1 if unknown.
+ */
+caliPileWire::caliPileWire(TwoWire &wireBus, int8_t sdaPin, int8_t sclPin) : wire(wireBus), sda(sdaPin), scl(sclPin), timeout(0), pointerResult(0) {
+}
+
+/**
+ * @brief Writes a block of bytes to a device.
+ * 
+ * @param address The address of the device.
+ * @param data The bytes to be written, starting with the register address.
+ * @param count The number of bytes to be written.
+ * @return The Wire.endTransmission() status, 0 on success.
+ */
+uint8_t caliPileWire::write(uint8_t address, const uint8_t *data, uint8_t count) {
+    wire.beginTransmission(address);
+    wire.write(data, count);
+    return wire.endTransmission();
+}
+
+/**
+ * @brief Writes a register pointer and reads back a block of bytes.
+ * 
+ * The pointer write ends without a STOP condition so the read follows with a
+ * repeated START and no other master can take the bus in between.
+ * 
+ * @param address The address of the device.
+ * @param reg The first register to be read.
+ * @param target Pointer to an array where the read data will be stored.
+ * @param count The number of bytes to be read.
+ * @return The number of bytes actually read.
+ */
+uint8_t caliPileWire::writeRead(uint8_t address, uint8_t reg, uint8_t *target, uint8_t count) {
+    wire.beginTransmission(address);
+    wire.write(reg);
+    pointerResult = wire.endTransmission(false);
+    if (pointerResult != 0) {
+        return 0;
+    }
+    wire.requestFrom(address, count);
+    uint8_t received = 0;
+    while (received < count && wire.available()) {
+        target[received++] = wire.read();
+    }
+    return received;
+}
+
+/**
+ * @brief Returns the endTransmission() result of the last pointer write.
+ * 
+ * @return 0 if the device acknowledged, 2 or 3 for a NACK, 4 or 5 for a bus error or timeout.
+ */
+uint8_t caliPileWire::pointerStatus() {
+    return pointerResult;
+}
+
+/**
+ * @brief Sets the hardware timeout of the TwoWire, where the core has one.
+ * 
+ * @param timeoutMicros The limit per transfer in microseconds, 0 for none.
+ */
+void caliPileWire::setTimeout(uint32_t timeoutMicros) {
+    timeout = timeoutMicros;
+#if defined(WIRE_HAS_TIMEOUT)
+    wire.setWireTimeout(timeoutMicros, true);
+#elif defined(ARDUINO_ARCH_ESP32)
+    wire.setTimeOut((timeoutMicros + 999) / 1000);
+#endif
+}
+
+/**
+ * @brief Tells whether the last transfer hit the hardware timeout.
+ * 
+ * @return true once per timeout; the flag is cleared by reading it.
+ */
+bool caliPileWire::timedOut() {
+#if defined(WIRE_HAS_TIMEOUT)
+    if (wire.getWireTimeoutFlag()) {
+        wire.clearWireTimeoutFlag();
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * @brief Frees the bus and re-initializes the TwoWire.
+ * 
+ * A slave interrupted in the middle of a read (e.g. by a reset of the
+ * master) keeps SDA low until it has clocked out its byte. Up to nine SCL
+ * pulses finish that byte, then a STOP condition resets the slave's state.
+ * The TwoWire restarts at its default clock; call setClock() again if
+ * another one is used.
+ * 
+ * @return true if SDA is high after the sequence, or if no pins are known.
  */
-void caliPile::readRegisters(uint8_t address, uint8_t altAddress, uint8_t count, uint8_t *target) {
-    Wire.beginTransmission(address);
-    Wire.write(altAddress);
-    Wire.endTransmission();
-    Wire.requestFrom(address, count);
-    for (uint8_t i = 0; i < count; i++) {
-        if (Wire.available()) {
-            target[i] = Wire.read();
+bool caliPileWire::recover() {
+    bool released = true;
+    if (sda >= 0 && scl >= 0) {
+        wire.end();
+        pinMode(sda, INPUT_PULLUP);
+        pinMode(scl, INPUT_PULLUP);
+        for (uint8_t i = 0; i < 9 && digitalRead(sda) == LOW; i++) {
+            pinMode(scl, OUTPUT);
+            digitalWrite(scl, LOW);
+            delayMicroseconds(5);
+            pinMode(scl, INPUT_PULLUP);
+            delayMicroseconds(5);
         }
+        // STOP: SDA rises while SCL is high
+        pinMode(sda, OUTPUT);
+        digitalWrite(sda, LOW);
+        delayMicroseconds(5);
+        pinMode(sda, INPUT_PULLUP);
+        delayMicroseconds(5);
+        released = digitalRead(sda) == HIGH;
     }
-}
\ No newline at end of file
+    wire.begin();
+    setTimeout(timeout);
+    return released;
+}
+#endif
\ No newline at end of file
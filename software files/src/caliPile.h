@@ -1,79 +1,303 @@
 #ifndef caliPile_h
 #define caliPile_h
 
+// Built outside the Arduino core on Linux: use i2c-dev (caliPileLinuxI2C)
+#if defined(__linux__) && !defined(ARDUINO)
+#define CALIPILE_LINUX
+#endif
+
+#ifdef CALIPILE_LINUX
+#include <atomic>
+#include "caliPileHost.h"
+#else
 #include "Arduino.h"
 #include "Wire.h"
-// Sensor registers
-#define SENSOR_ADDRESS 0x0C
-#define TPOBJECT 1
-#define TPAMBIENT 3
-#define TPOBJLP1 5
-#define TPOBJLP2 7
-#define TPAMBLP3 10
-#define TPOBJLP2_FRZN 12
-#define TPPRESENCE 15
-#define TPMOTION 16
-#define TPAMB_SHOCK 17
-#define INTERRUPT_STATUS 18
-#define CHIP_STATUS 19
-#define SLP12 20
-#define SLP3 21
-#define TP_PRES_THLD 22
-#define TP_MOT_THLD 23
-#define TP_AMB_SHOCK_THLD 24
-#define INT_MASK 25
-#define SRC_SELECT 26
-#define TMR_INT 27
-#define TPOT_THR 28
-// EEPROM addresses
-#define EEPROM_CONTROL 31
-#define EEPROM_PROTOCOL 32
-#define EEPROM_CHECKSUM 33
-#define EEPROM_LOOKUPNUM 41
-#define EEPROM_PTAT25 42
-#define EEPROM_M 44
-#define EEPROM_U0 46
-#define EEPROM_UOUT1 48
-#define EEPROM_TOBJ1 50
-#define SLAVE_ADDRESS 63
-// Low-pass time
-#define LP_512s 0x00
-#define LP_256s 0x01
-#define LP_128s 0x02
-#define LP_64s 0x03
-#define LP_32s 0x04
-#define LP_16s 0x05
-#define LP_8s 0x08
-#define LP_4s 0x09
-#define LP_2s 0x0A
-#define LP_1s 0x0B
-#define LP_0_50s 0x0C
-#define LP_0_25s 0x0D
-// Source select
-#define src_TPOBJ_TPOBJLP2 0x00
-#define src_TPOBJLP1_TPOBJLP2 0x01
-#define src_TPOBJ_TPOBJLP2FRZN 0x02
-#define src_TPOBJLP1_TPOBJLP2FRZN 0x03
-// Cycle time
-#define ms30 0x00
-#define ms60 0x01
-#define ms120 0x02
-#define ms240 0x03
+#endif
+#include "caliPileRegisters.h"
+
+// Uncomment to keep a ledger of the I2C transactions issued by each instance
+//#define CALIPILE_BUS_STATS
+// Uncomment to time every call of the public methods of each instance
+//#define CALIPILE_METHOD_STATS
+
+// Operations of the non-blocking API
+#define ASYNC_NONE 0
+#define ASYNC_ACTIVATE 1
+#define ASYNC_CALIBRATION 2
+#define ASYNC_MOTION 3
+#define ASYNC_SNAPSHOT 4
+// Results of poll()
+#define ASYNC_IDLE 0
+#define ASYNC_BUSY 1
+#define ASYNC_DONE 2
+#define ASYNC_ERROR 3
+// Result block from TPOBJECT to CHIP_STATUS
+#define SNAPSHOT_LENGTH 19
+// Default deadline of one register access, in microseconds
+#define BUS_TIMEOUT_US 25000
+// Time the sensor does not answer after the general call reload, in milliseconds
+#define RELOAD_MS 10
+
+/**
+ * @brief Result of a register access, see caliPile::lastError().
+ */
+enum caliPileError {
+    BUS_OK = 0,
+    // The sensor did not acknowledge its address or a data byte
+    BUS_NACK,
+    // Fewer bytes than requested arrived; the missing ones read as 0
+    BUS_SHORT_READ,
+    // The access missed its deadline; the bus has been recovered
+    BUS_TIMEOUT,
+    // Other bus failure, e.g. lost arbitration; the bus has been recovered
+    BUS_ERROR
+};
 
 extern bool newInt;
 
+// EEPROM_LOOKUPNUM of a TPiS 1S; other values are treated as TPiS 1T
+#define LOOKUP_TPIS_1S 1
+
+/**
+ * @brief Sensor variant TPiS 1S: object signal proportional to T^3.8.
+ *
+ * Pass as the template argument of caliPile::calcObjectTemp() to fix the
+ * variant at compile time; exponent and reciprocal fold into constants.
+ */
+struct caliPileTPiS1S {
+    static constexpr float exponent() { return 3.8f; }
+    static constexpr float reciprocal() { return 1.0f / 3.8f; }
+};
+
+/**
+ * @brief Sensor variant TPiS 1T: object signal proportional to T^4.2.
+ */
+struct caliPileTPiS1T {
+    static constexpr float exponent() { return 4.2f; }
+    static constexpr float reciprocal() { return 1.0f / 4.2f; }
+};
+
+/**
+ * @brief Raw copy of the result registers TPOBJECT..CHIP_STATUS.
+ *
+ * Filled by caliPile::readSnapshot() in a single burst, so every field
+ * comes from the same conversion cycle. The accessors decode the fields
+ * exactly like the matching caliPile getters.
+ */
+struct caliPileSnapshot {
+    uint8_t raw[SNAPSHOT_LENGTH];
+
+    uint32_t objectTemp() const;
+    uint16_t ambientTemp() const;
+    uint32_t objectTempLP1() const;
+    uint32_t objectTempLP2() const;
+    uint32_t objectTempLP1Raw() const;
+    uint32_t objectTempLP2Raw() const;
+    uint16_t ambientTempLP3() const;
+    uint32_t objectTempLP2Frozen() const;
+    uint8_t presenceStat() const;
+    uint8_t motionStat() const;
+    uint8_t ambientShockStat() const;
+    uint8_t interruptStatus() const;
+    uint8_t chipStatus() const;
+};
+
+/**
+ * @brief Calibration constants of one sensor, as derived by TempCalculations().
+ *
+ * address and checksum identify the device the constants belong to.
+ */
+struct caliPileCalibration {
+    uint8_t address;
+    uint8_t lookup;
+    uint16_t checksum;
+    uint16_t PTAT25, M, U0;
+    uint32_t UOUT1;
+    uint8_t TOBJ1;
+    float k;
+};
+
+#ifdef CALIPILE_BUS_STATS
+// Default bus clock used to model the time spent on the wire
+#define BUS_CLOCK_HZ 100000
+
+/**
+ * @brief Cumulative I2C cost recorded by a caliPile instance.
+ *
+ * A transaction is one START..STOP frame on the bus. A register read is one
+ * frame, since the pointer write and the read are joined by a repeated START.
+ * Bytes include the address bytes. busMicros is modeled from the frame length
+ * at the configured bus clock: START + 9 clocks per byte (with ACK) + STOP.
+ */
+struct caliPileBusStats {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t busMicros;
+    // Writes and register pointer writes of reads the sensor did not acknowledge
+    uint32_t nacks;
+    // Other failures reported by the bus, e.g. timeouts or lost arbitration
+    uint32_t busErrors;
+    // Reads that returned fewer bytes than requested after an acknowledged pointer write
+    uint32_t shortReads;
+    // Accesses that missed the deadline set with setBusTimeout()
+    uint32_t timeouts;
+    // Recovery sequences run after a timeout or bus error
+    uint32_t recoveries;
+    // Longest measured access, in microseconds
+    uint32_t maxMicros;
+};
+#endif
+
+#ifdef CALIPILE_METHOD_STATS
+// Methods timed by CALIPILE_METHOD_STATS, indices into methodStats()
+#define STAT_ACTIVATE 0
+#define STAT_INTERRUPT_STATUS 1
+#define STAT_INIT_MOTION 2
+#define STAT_TEMP_CALCULATIONS 3
+#define STAT_POLL 4
+#define STAT_SYNC_CONFIG 5
+#define STAT_FLUSH_CONFIG 6
+#define STAT_TPOT_THRESHOLD 7
+#define STAT_MOTION_THRESHOLD 8
+#define STAT_PRESENCE_THRESHOLD 9
+#define STAT_AMBIENT_TEMP 10
+#define STAT_OBJECT_TEMP 11
+#define STAT_OBJECT_TEMP_LP1 12
+#define STAT_OBJECT_TEMP_LP2 13
+#define STAT_AMBIENT_TEMP_LP3 14
+#define STAT_OBJECT_TEMP_LP2_FROZEN 15
+#define STAT_PRESENCE 16
+#define STAT_MOTION 17
+#define STAT_AMBIENT_SHOCK 18
+#define STAT_READ_SNAPSHOT 19
+#define STAT_CONVERT_CELSIUS 20
+#define STAT_CALC_AMBIENT 21
+#define STAT_CALC_OBJECT 22
+#define STAT_INIT_TIMER 23
+#define STAT_READ_TIMED_SNAPSHOT 24
+#define STAT_METHODS 25
+
+/**
+ * @brief Call count and time spent in one public method of a caliPile instance.
+ *
+ * Times are measured with micros() from entry to return, so they include the
+ * bus transfers and any nested calls (activateSensor() includes poll()).
+ */
+struct caliPileMethodStats {
+    uint32_t calls;
+    uint32_t totalMicros;
+    uint32_t maxMicros;
+};
+#endif
+
+/**
+ * @brief Transport used by caliPile to reach the sensor.
+ *
+ * Implement this to run a sensor over something other than an Arduino
+ * TwoWire instance. Both calls are one bus transaction each.
+ *
+ * The bus also counts the general call reloads sent over it, which reset
+ * every sensor on the wire. Sensors sharing a physical bus must share the
+ * caliPileBus object, so each instance learns of reloads sent by another.
+ * On Linux the counter is atomic, so instances on different threads can
+ * share the object when the transport serializes its transfers.
+ */
+class caliPileBus {
+public:
+    caliPileBus() : reloads(0), reloadedAt(0) {}
+    // Returns 0 on success, otherwise an endTransmission() style error code
+    virtual uint8_t write(uint8_t address, const uint8_t *data, uint8_t count) = 0;
+    // Register pointer write, repeated START, read; returns the bytes received
+    virtual uint8_t writeRead(uint8_t address, uint8_t reg, uint8_t *target, uint8_t count) = 0;
+    // write() style result of the pointer write of the last writeRead(), 0 if it went through
+    virtual uint8_t pointerStatus() { return 0; }
+    // Limits how long one transfer may hold the bus, 0 for no limit
+    virtual void setTimeout(uint32_t timeoutMicros) { (void) timeoutMicros; }
+    // Tells whether the last transfer was aborted by that limit
+    virtual bool timedOut() { return false; }
+    // Frees a bus held low by a slave and re-initializes it; true if SDA is released
+    virtual bool recover() { return false; }
+    // Records a general call reload, see caliPile::beginActivate()
+    void noteReload() { reloadedAt = millis(); reloads++; }
+    // Reloads sent so far, wrapping around
+    uint8_t reloadCount() const { return reloads; }
+    // millis() when the last reload was sent
+    uint32_t lastReload() const { return reloadedAt; }
+
+protected:
+    ~caliPileBus() {}
+
+private:
+#ifdef CALIPILE_LINUX
+    std::atomic<uint8_t> reloads;
+    std::atomic<uint32_t> reloadedAt;
+#else
+    uint8_t reloads;
+    uint32_t reloadedAt;
+#endif
+};
+
+#ifndef CALIPILE_LINUX
+/**
+ * @brief caliPileBus over an Arduino TwoWire instance (Wire, Wire1, ...).
+ */
+class caliPileWire : public caliPileBus {
+public:
+    caliPileWire(TwoWire &wireBus, int8_t sdaPin = -1, int8_t sclPin = -1);
+    uint8_t write(uint8_t address, const uint8_t *data, uint8_t count);
+    uint8_t writeRead(uint8_t address, uint8_t reg, uint8_t *target, uint8_t count);
+    uint8_t pointerStatus();
+    void setTimeout(uint32_t timeoutMicros);
+    bool timedOut();
+    bool recover();
+
+private:
+    TwoWire &wire;
+    int8_t sda, scl;
+    uint32_t timeout;
+    uint8_t pointerResult;
+};
+#endif
+
+class caliPile;
+typedef void (*caliPileCallback)(caliPile &sensor, uint8_t operation);
+
 class caliPile {
 public:
+#ifndef CALIPILE_LINUX
     caliPile(uint8_t pin);
+#endif
+    caliPile(uint8_t pin, caliPileBus &sensorBus, uint8_t address = SENSOR_ADDRESS);
+    uint8_t address() const;
+    uint16_t cycleTimeMs() const;
+    bool sameBus(const caliPile &other) const;
     //void myinthandler();
     void activateSensor();
     uint8_t interruptStatus();
     void readMemory();
     void initMotion(uint8_t LPTime1, uint8_t LPTime2, uint8_t tempSource, uint8_t cycleTime);
-    void TempCalculations();
+    bool TempCalculations();
+    caliPileCalibration calibration() const;
+    bool loadCalibration(const caliPileCalibration &cal);
+    bool beginActivate();
+    bool beginCalibration();
+    bool beginMotion(uint8_t LPTime1, uint8_t LPTime2, uint8_t tempSource, uint8_t cycleTime);
+    bool beginSnapshot(caliPileSnapshot &snapshot);
+    void onComplete(caliPileCallback callback);
+    uint8_t poll();
+    bool isBusy() const;
+    bool isCalibrationValid() const;
+    void syncConfig();
+    void invalidateConfig();
+    bool isConfigKnown(uint8_t reg) const;
+    uint8_t configValue(uint8_t reg) const;
+    void setConfig(uint8_t reg, uint8_t value);
+    void flushConfig();
     void initTPotThreshHold(uint16_t Tcounts);
     void initTpMotionThreshHold(uint16_t Tcounts);
     void initTpPresenceThreshHold(uint16_t Tcounts);
+    uint16_t initTimer(uint16_t periodMs);
+    uint8_t readTimedSnapshot(caliPileSnapshot &snapshot);
     float getAmbientTemp();
     uint32_t getObjectTemp();
     uint32_t getObjectTempLP1();
@@ -83,22 +307,118 @@ public:
     uint8_t getPresenceStat();
     uint8_t getMotionStat();
     uint8_t getAmbientShockStat();
+    uint8_t readSnapshot(caliPileSnapshot &snapshot);
     float convertToCelcius(float temp_val);
     float calcAmbientTemp(uint16_t ambientTemp);
     float calcObjectTemp(uint32_t objectTemp, float ambientTemp);
-    void writeRegister(uint8_t address, uint8_t altAddress, uint8_t data);
+    template <class Variant> float calcObjectTemp(uint32_t objectTemp, float ambientTemp) const;
+    float conversionK() const;
+    float conversionK(float n) const;
+    bool isTPiS1S() const;
+    float exponent() const;
+    void setBusTimeout(uint32_t timeoutMicros);
+    uint8_t lastError() const;
+    uint8_t writeRegister(uint8_t address, uint8_t altAddress, uint8_t data);
+    uint8_t writeRegisters(uint8_t address, uint8_t altAddress, uint8_t count, const uint8_t *data);
     uint8_t readRegister(uint8_t address, uint8_t altAddress);
-    void readRegisters(uint8_t address, uint8_t altAddress, uint8_t count, uint8_t *target);
+    uint8_t readRegisters(uint8_t address, uint8_t altAddress, uint8_t count, uint8_t *target);
     uint8_t tempData[3] = {0, 0, 0};
 
     uint16_t PTAT25, M, U0, CHECKSUM;
     uint32_t UOUT1;
     uint8_t TOBJ1, lookup;
-    float k, AmbientT, ObjectT;
+    // 0 until conversionK() derives it from the constants above
+    mutable float k;
+    float AmbientT, ObjectT;
     uint8_t interruptPin;
+
+#ifdef CALIPILE_BUS_STATS
+    const caliPileBusStats &busStats() const;
+    void resetBusStats();
+    void setBusClock(uint32_t clockHz);
+#endif
+#ifdef CALIPILE_METHOD_STATS
+    const caliPileMethodStats *methodStats() const;
+    void resetMethodStats();
+    static const char *methodName(uint8_t method);
+#endif
     
 private:
+    caliPileBus *bus;
+    uint8_t deviceAddress;
+    uint8_t cycle;
+
+    bool beginAsync(uint8_t operation);
+    void finishAsync();
+    bool decodeCalibration(const uint8_t *eeprom);
+    bool flushConfigStep();
+    void checkReload();
+    void restoreConfig();
+    float deriveK(float n) const;
+    void stageMotion(uint8_t LPTime1, uint8_t LPTime2, uint8_t tempSource, uint8_t cycleTime);
+
+    // k for an exponent other than the detected one, see conversionK(float)
+    mutable float variantK;
+    mutable float variantExponent;
+
+    uint8_t asyncOperation;
+    uint8_t asyncStep;
+    uint8_t asyncArgs[5];
+    uint32_t asyncStart;
+    caliPileSnapshot *asyncSnapshot;
+    caliPileCallback asyncCallback;
+    bool calibrationValid;
+
+    // Write-through shadow of SLP12..TPOT_THR + 1, one bit per register
+    uint8_t config[CONFIG_LENGTH];
+    uint16_t configKnown;
+    uint16_t configDirty;
+
+    uint32_t beginTransfer();
+    uint8_t finishTransfer(uint8_t error, uint32_t start);
+    void recoverBus();
+
+    uint32_t busTimeout;
+    bool timeoutApplied;
+    bool recovering;
+    uint8_t busError;
+    // Bytes delivered by the last readRegisters()
+    uint8_t readCount;
+    // bus->reloadCount() when the shadow copy last caught up with it
+    uint8_t reloadsSeen;
+    // The shadow copy must be written back once the sensor answers again
+    bool restorePending;
+
+#ifdef CALIPILE_BUS_STATS
+    void recordTransaction(uint8_t writeBytes, uint8_t readBytes, uint8_t received, uint8_t error);
+
+    caliPileBusStats stats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint32_t busClockHz = BUS_CLOCK_HZ;
+#endif
+#ifdef CALIPILE_METHOD_STATS
+    caliPileMethodStats methods[STAT_METHODS] = {};
+#endif
 
 };
 
+/**
+ * @brief Calculates the object temperature for a variant fixed at compile time.
+ * 
+ * Same formula as calcObjectTemp(uint32_t, float), with the exponent and its
+ * reciprocal taken from Variant (caliPileTPiS1S or caliPileTPiS1T) instead
+ * of the LOOKUP# read from the EEPROM. k is derived for the same exponent
+ * (see conversionK(float)); with the variant the EEPROM reports it is the
+ * cached k of calcObjectTemp(uint32_t, float).
+ * 
+ * @param objectTemp The raw object temperature reading.
+ * @param ambientTemp The calculated ambient temperature in degrees Kelvin.
+ * @return The calculated object temperature.
+ */
+template <class Variant>
+float caliPile::calcObjectTemp(uint32_t objectTemp, float ambientTemp) const {
+    float temp0 = powf(ambientTemp, Variant::exponent());
+    float temp1 = (((float) objectTemp) - ((float) U0)) / conversionK(Variant::exponent());
+    return powf(temp0 + temp1, Variant::reciprocal());
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "caliPileArray.h"
+
+/**
+ * @brief Constructor for the caliPileArray class.
+ * 
+ * The array starts empty; add sensors with add() and call provision().
+ */
+caliPileArray::caliPileArray() : online(0), count(0), next(0) {
+}
+
+/**
+ * @brief Adds a sensor to the array.
+ * 
+ * @param sensor The sensor to be managed. It has to outlive the array.
+ * @return false if the array is full or a sensor with the same address on
+ *         the same bus is already part of it.
+ */
+bool caliPileArray::add(caliPile &sensor) {
+    if (count >= ARRAY_MAX_SENSORS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (sensors[i]->address() == sensor.address() && sensors[i]->sameBus(sensor)) {
+            return false;
+        }
+    }
+    sensors[count] = &sensor;
+    lastRead[count] = 0;
+    interval[count] = 0;
+    timerPeriods[count] = 0;
+    latched[count] = 0;
+    count++;
+    return true;
+}
+
+/**
+ * @brief Brings all sensors of the array up.
+ * 
+ * This function sends the general call reload on every bus so each sensor
+ * latches the address selected by its A1/A0 pins, then reads the SLAVE_ADDRESS
+ * register of every sensor to confirm it answers at the expected address.
+ * SLAVE_ADDRESS is an EEPROM cell, so EEPROM access is enabled around the read.
+ * Sensors that do not answer are skipped by service().
+ * 
+ * @return The number of sensors found online.
+ */
+uint8_t caliPileArray::provision() {
+    for (uint8_t i = 0; i < count; i++) {
+        bool reloaded = false;
+        for (uint8_t j = 0; j < i; j++) {
+            reloaded |= sensors[j]->sameBus(*sensors[i]);
+        }
+        if (!reloaded) {
+            sensors[i]->activateSensor();
+        }
+    }
+
+    online = 0;
+    uint8_t found = 0;
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t slaveAddress = 0;
+        sensors[i]->writeRegister(sensors[i]->address(), EEPROM_CONTROL, 0x80);
+        sensors[i]->readRegisters(sensors[i]->address(), SLAVE_ADDRESS, 1, &slaveAddress);
+        sensors[i]->writeRegister(sensors[i]->address(), EEPROM_CONTROL, 0x00);
+        // Bit 7 enables the A1/A0 pins, which replace the two low address bits
+        uint8_t mask = (slaveAddress & 0x80) ? (0x7F & ~(ARRAY_ADDRESSES_PER_BUS - 1)) : 0x7F;
+        if (slaveAddress != 0 && (slaveAddress & mask) == (sensors[i]->address() & mask)) {
+            online |= (uint16_t) 1 << i;
+            lastRead[i] = now - sensors[i]->cycleTimeMs();
+            interval[i] = sensors[i]->cycleTimeMs() * 16;
+            // The general call cleared TMR_INT and INT_MASK
+            timerPeriods[i] = 0;
+            latched[i] = 0;
+            found++;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Returns the number of sensors added to the array.
+ * 
+ * @return The number of sensors.
+ */
+uint8_t caliPileArray::size() const {
+    return count;
+}
+
+/**
+ * @brief Returns a sensor of the array.
+ * 
+ * @param index The position of the sensor, in the order it was added.
+ * @return The sensor at that position.
+ */
+caliPile &caliPileArray::sensor(uint8_t index) {
+    return *sensors[index];
+}
+
+/**
+ * @brief Tells whether a sensor answered during provision().
+ * 
+ * @param index The position of the sensor, in the order it was added.
+ * @return true if the sensor is online.
+ */
+bool caliPileArray::isOnline(uint8_t index) const {
+    return index < count && (online & ((uint16_t) 1 << index));
+}
+
+/**
+ * @brief Reads the sensor whose result has been waiting longest.
+ * 
+ * Call this as often as possible from loop(). At most one sensor is read per
+ * call, with a single snapshot transaction. Ties are broken round-robin so
+ * sensors with the same cycle time take turns.
+ * 
+ * A read that finds INT_TIMER clear came before the sensor's timer period
+ * ended: the handler is not called, the flags it cleared are kept for the
+ * next snapshot and the sensor's probe interval grows by 1 ms plus 1/32 of
+ * its cycle time. Every delivered read shortens it by a sixteenth of that,
+ * so the interval follows the sensor oscillator with about one early read
+ * in 16 samples. A sensor still early at the longest interval lost its
+ * timer, e.g. to the reload of a bus recovery, and has it programmed again.
+ * 
+ * @param handler The function receiving the snapshot.
+ * @return The index of the sensor whose snapshot was delivered, or -1 if
+ *         none was due yet or the one read had no new timer period.
+ */
+int8_t caliPileArray::service(caliPileSampleHandler handler) {
+    uint32_t now = millis();
+    int8_t due = -1;
+    uint32_t longestWait = 0;
+    for (uint8_t n = 0; n < count; n++) {
+        uint8_t i = (next + n) % count;
+        if (!isOnline(i)) {
+            continue;
+        }
+        uint32_t elapsed = now - lastRead[i];
+        uint16_t wait = (interval[i] + 15) / 16;
+        if (elapsed >= wait && (due < 0 || elapsed - wait > longestWait)) {
+            due = i;
+            longestWait = elapsed - wait;
+        }
+    }
+    if (due < 0) {
+        return -1;
+    }
+
+    caliPile &target = *sensors[due];
+    uint16_t period = target.cycleTimeMs();
+    if (timerPeriods[due] != period / 30) {
+        // First read or initMotion() changed the cycle: restart the timer
+        timerPeriods[due] = target.initTimer(period) / 30;
+        interval[due] = period * 16;
+        lastRead[due] = now;
+        latched[due] = 0;
+        return -1;
+    }
+
+    caliPileSnapshot snapshot;
+    if (target.readSnapshot(snapshot) != BUS_OK) {
+        lastRead[due] = now;
+        return -1;
+    }
+    next = (due + 1) % count;
+    uint8_t &status = snapshot.raw[INTERRUPT_STATUS - TPOBJECT];
+    uint16_t step = 1 + period / 32;
+    if (!(status & INT_TIMER)) {
+        // Early: the host clock runs ahead of this sensor
+        latched[due] |= status;
+        uint16_t longest = period * 2 * ARRAY_INTERVAL_MAX_EIGHTHS;
+        if (interval[due] >= longest) {
+            // No period even at the slowest oscillator: the timer was lost.
+            // The shadow copy may still hold it, so read the registers back
+            // for initTimer() to write it again
+            timerPeriods[due] = 0;
+            target.syncConfig();
+        }
+        interval[due] += step * 16;
+        if (interval[due] > longest) {
+            interval[due] = longest;
+        }
+        return -1;
+    }
+    status |= latched[due];
+    latched[due] = 0;
+    lastRead[due] = now;
+    uint16_t shortest = period * 2 * ARRAY_INTERVAL_MIN_EIGHTHS;
+    interval[due] = (interval[due] > shortest + step) ? interval[due] - step : shortest;
+
+    handler(due, target, snapshot);
+    return due;
+}
+
+/**
+ * @brief Returns how long the controller may sleep before the next result is due.
+ * 
+ * @return Milliseconds until the next sensor is probed, 0 if one is already
+ *         due, or 0xFFFFFFFF if no sensor is online.
+ */
+uint32_t caliPileArray::millisUntilDue() const {
+    uint32_t now = millis();
+    uint32_t shortest = 0xFFFFFFFF;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!isOnline(i)) {
+            continue;
+        }
+        uint32_t elapsed = now - lastRead[i];
+        uint16_t probe = (interval[i] + 15) / 16;
+        uint32_t wait = (elapsed >= probe) ? 0 : probe - elapsed;
+        if (wait < shortest) {
+            shortest = wait;
+        }
+    }
+    return shortest;
+}
@@ -0,0 +1,60 @@
+#ifndef caliPileArray_h
+#define caliPileArray_h
+
+#include "caliPile.h"
+
+// Sensors one array can manage
+#define ARRAY_MAX_SENSORS 16
+// Pin selectable addresses: SENSOR_ADDRESS with A1/A0 in the two low bits
+#define ARRAY_ADDRESSES_PER_BUS 4
+// Limits of the probe interval, in 1/8 of the cycle time; the on-chip
+// oscillator runs at 54..76 kHz against 64 kHz typical (datasheet table 10)
+#define ARRAY_INTERVAL_MIN_EIGHTHS 6
+#define ARRAY_INTERVAL_MAX_EIGHTHS 10
+
+typedef void (*caliPileSampleHandler)(uint8_t index, caliPile &sensor, const caliPileSnapshot &snapshot);
+
+/**
+ * @brief Manages several caliPile sensors on one controller.
+ *
+ * Each bus can carry four sensors at SENSOR_ADDRESS..SENSOR_ADDRESS + 3,
+ * selected with the A1/A0 pins of the breakout. provision() reloads the
+ * addresses with the general call and checks that every sensor answers at
+ * its address. service() then reads the result block of one sensor per
+ * call, picking the one whose result has been waiting longest.
+ *
+ * Each sensor is paced by its own on-chip timer, programmed by service()
+ * to the cycle time (ms30..ms240 from initMotion()), the interval of the
+ * motion differentiation, so every sample carries a new TP_MOTION. A
+ * snapshot is handed on only when its INTERRUPT_STATUS shows INT_TIMER, so
+ * no timer period is read twice however far the host clock drifts from the
+ * sensor oscillator.
+ * The host clock only decides when to look: the probe interval of every
+ * sensor is learned from the reads that came too early, within
+ * ARRAY_INTERVAL_MIN_EIGHTHS..ARRAY_INTERVAL_MAX_EIGHTHS of the cycle time.
+ * The timer also sets INT_TIMER in INT_MASK, so a wired INT pin falls once
+ * per period.
+ */
+class caliPileArray {
+public:
+    caliPileArray();
+    bool add(caliPile &sensor);
+    uint8_t provision();
+    uint8_t size() const;
+    caliPile &sensor(uint8_t index);
+    bool isOnline(uint8_t index) const;
+    int8_t service(caliPileSampleHandler handler);
+    uint32_t millisUntilDue() const;
+
+private:
+    caliPile *sensors[ARRAY_MAX_SENSORS];
+    uint32_t lastRead[ARRAY_MAX_SENSORS];
+    uint16_t interval[ARRAY_MAX_SENSORS];  // probe interval in 1/16 ms
+    uint8_t timerPeriods[ARRAY_MAX_SENSORS];
+    uint8_t latched[ARRAY_MAX_SENSORS];
+    uint16_t online;
+    uint8_t count;
+    uint8_t next;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "caliPileBatch.h"
+
+// Type punning through a union, which GCC and Clang keep in registers
+union caliPileFloatBits {
+    float value;
+    uint32_t bits;
+};
+
+static inline uint32_t floatBits(float value) {
+    caliPileFloatBits pun;
+    pun.value = value;
+    return pun.bits;
+}
+
+static inline float bitsFloat(uint32_t bits) {
+    caliPileFloatBits pun;
+    pun.bits = bits;
+    return pun.value;
+}
+
+// Body of caliPileFastPow(), inlined into the batch loops so they vectorize
+static inline float fastPow(float x, float p) {
+    uint32_t bits = floatBits(x);
+    int32_t exponent = (int32_t) ((bits >> 23) & 0xFF) - 127;
+    float mantissa = bitsFloat((bits & 0x007FFFFF) | 0x3F800000);
+    // Halve mantissas above sqrt(2) arithmetically so the loops stay branch free
+    int32_t above = mantissa > 1.41421356f;
+    mantissa *= 1.0f - 0.5f * (float) above;
+    exponent += above;
+
+    float s = (mantissa - 1.0f) / (mantissa + 1.0f);
+    float s2 = s * s;
+    float ln = 2.0f * s * (1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f))));
+    float y = p * ((float) exponent + ln * 1.44269504f);
+
+    // Round to nearest with the 1.5 * 2^23 trick, valid for |y| < 2^22
+    float whole = (y + 12582912.0f) - 12582912.0f;
+    float f = (y - whole) * 0.693147181f;
+    float e = 1.0f + f * (1.0f + f * (0.5f + f * (1.0f / 6.0f + f * (1.0f / 24.0f + f * (1.0f / 120.0f + f * (1.0f / 720.0f))))));
+    return bitsFloat(floatBits(e) + ((uint32_t) (int32_t) whole << 23));
+}
+
+/**
+ * @brief Raises x to the power p without libm.
+ * 
+ * log2(x) is split into the exponent and a mantissa in [0.707, 1.414], whose
+ * logarithm comes from the series ln(m) = 2 * (s + s^3/3 + s^5/5 + s^7/7) with
+ * s = (m - 1) / (m + 1), |s| <= 0.172 (truncation below 2e-8). 2^y is split
+ * into round(y) and a fraction in [-0.5, 0.5], evaluated with a degree 6
+ * Taylor polynomial of e^(f ln 2) (truncation below 2e-7). The rest of the
+ * error comes from float rounding of y = p * log2(x) and grows with |y|.
+ * 
+ * @param x The base, must be positive and normal.
+ * @param p The exponent.
+ * @return x^p with a relative error below 3e-6 for |y| <= 40 and below 1e-5
+ *         whenever the result is a normal float.
+ */
+float caliPileFastPow(float x, float p) {
+    return fastPow(x, p);
+}
+
+/**
+ * @brief Converts raw ambient counts to Kelvin.
+ * 
+ * Same formula as caliPile::calcAmbientTemp().
+ * 
+ * @param cal The calibration of the sensor that produced the samples.
+ * @param ambientRaw The raw TPAMBIENT counts.
+ * @param ambientK Output, the ambient temperatures in Kelvin.
+ * @param count The number of samples.
+ */
+void caliPileAmbientBatch(const caliPileCalibration &cal, const uint16_t *ambientRaw, float *ambientK, size_t count) {
+    const uint16_t *__restrict in = ambientRaw;
+    float *__restrict out = ambientK;
+    const float ptat25 = (float) cal.PTAT25;
+    const float invM = 1.0f / (float) cal.M;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = 298.15f + ((float) in[i] - ptat25) * invM;
+    }
+}
+
+/**
+ * @brief Converts raw object counts to Kelvin.
+ * 
+ * Same formula as caliPile::calcObjectTemp(), with caliPileFastPow() in place
+ * of powf().
+ * 
+ * @param cal The calibration of the sensor that produced the samples.
+ * @param exponent The exponent of the sensor variant (3.8 for TPiS 1S, 4.2 for TPiS 1T), e.g. caliPile::exponent().
+ * @param objectRaw The raw TPOBJECT counts.
+ * @param ambientK The ambient temperatures in Kelvin, as from caliPileAmbientBatch().
+ * @param objectK Output, the object temperatures in Kelvin.
+ * @param count The number of samples.
+ */
+void caliPileObjectBatch(const caliPileCalibration &cal, float exponent, const uint32_t *objectRaw, const float *ambientK, float *objectK, size_t count) {
+    const uint32_t *__restrict object = objectRaw;
+    const float *__restrict ambient = ambientK;
+    float *__restrict out = objectK;
+    const float u0 = (float) cal.U0;
+    const float invK = 1.0f / cal.k;
+    const float invExponent = 1.0f / exponent;
+    for (size_t i = 0; i < count; i++) {
+        float temp0 = fastPow(ambient[i], exponent);
+        float temp1 = ((float) object[i] - u0) * invK;
+        out[i] = fastPow(temp0 + temp1, invExponent);
+    }
+}
+
+/**
+ * @brief Converts raw object and ambient counts to Kelvin in one pass.
+ * 
+ * @param cal The calibration of the sensor that produced the samples.
+ * @param exponent The exponent of the sensor variant (3.8 for TPiS 1S, 4.2 for TPiS 1T), e.g. caliPile::exponent().
+ * @param objectRaw The raw TPOBJECT counts.
+ * @param ambientRaw The raw TPAMBIENT counts.
+ * @param objectK Output, the object temperatures in Kelvin.
+ * @param ambientK Output, the ambient temperatures in Kelvin.
+ * @param count The number of samples.
+ */
+void caliPileConvertBatch(const caliPileCalibration &cal, float exponent, const uint32_t *objectRaw, const uint16_t *ambientRaw, float *objectK, float *ambientK, size_t count) {
+    caliPileAmbientBatch(cal, ambientRaw, ambientK, count);
+    caliPileObjectBatch(cal, exponent, objectRaw, ambientK, objectK, count);
+}
+
+/**
+ * @brief Converts temperatures from Kelvin to Celsius.
+ * 
+ * @param kelvin The temperatures in Kelvin.
+ * @param celsius Output, the temperatures in Celsius. May be the same array as kelvin.
+ * @param count The number of samples.
+ */
+void caliPileCelsiusBatch(const float *kelvin, float *celsius, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        celsius[i] = kelvin[i] - 273.15f;
+    }
+}
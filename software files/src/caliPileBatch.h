@@ -0,0 +1,27 @@
+#ifndef caliPileBatch_h
+#define caliPileBatch_h
+
+#include "caliPile.h"
+
+/*
+ * Batch conversion of stored raw counts, e.g. when reprocessing history on a
+ * server. Inputs and outputs are plain parallel arrays (structure of arrays)
+ * and the loops are branch free, so compilers vectorize them at -O3.
+ *
+ * Both powf() calls of caliPile::calcObjectTemp() are replaced by
+ * caliPileFastPow(), an exp2(p * log2(x)) approximation built from an atanh
+ * series for log2 and a Taylor series for exp2. Its relative error is below
+ * 1e-5 for any positive, normal x whose result is a normal float, and below
+ * 3e-6 while |p * log2(x)| <= 40, which covers every temperature conversion.
+ * Measured against the double precision formula over -40 C .. +120 C the
+ * object temperature stays within 0.002 K.
+ */
+
+float caliPileFastPow(float x, float p);
+
+void caliPileAmbientBatch(const caliPileCalibration &cal, const uint16_t *ambientRaw, float *ambientK, size_t count);
+void caliPileObjectBatch(const caliPileCalibration &cal, float exponent, const uint32_t *objectRaw, const float *ambientK, float *objectK, size_t count);
+void caliPileConvertBatch(const caliPileCalibration &cal, float exponent, const uint32_t *objectRaw, const uint16_t *ambientRaw, float *objectK, float *ambientK, size_t count);
+void caliPileCelsiusBatch(const float *kelvin, float *celsius, size_t count);
+
+#endif
@@ -0,0 +1,144 @@
+#include <string.h>
+#include "caliPileCapture.h"
+
+static void putU16(uint8_t *data, uint16_t value) {
+    data[0] = value;
+    data[1] = value >> 8;
+}
+
+static void putU24(uint8_t *data, uint32_t value) {
+    putU16(data, value);
+    data[2] = value >> 16;
+}
+
+static void putU32(uint8_t *data, uint32_t value) {
+    putU24(data, value);
+    data[3] = value >> 24;
+}
+
+static void putF32(uint8_t *data, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putU32(data, bits);
+}
+
+static bool fitsInt8(int32_t value) {
+    return value >= -128 && value <= 127;
+}
+
+static bool fitsInt16(int32_t value) {
+    return value >= -32768 && value <= 32767;
+}
+
+/**
+ * @brief Constructor for the caliPileCaptureWriter class.
+ * 
+ * @param output Where the capture is written, e.g. Serial or a File.
+ * @param stream Stream number of this sensor, 0..CAPTURE_MAX_STREAMS - 1.
+ */
+caliPileCaptureWriter::caliPileCaptureWriter(Print &output, uint8_t stream) : out(output), streamId(stream & CAPTURE_STREAM_MASK), sinceKey(0), written(0) {
+    memset(&last, 0, sizeof(last));
+}
+
+/**
+ * @brief Writes the stream header.
+ * 
+ * Call after the calibration has been read (TempCalculations() or
+ * loadCalibration()) and again whenever the host may have missed it. The
+ * next sample is written as a key sample.
+ * 
+ * @param sensor The sensor whose calibration and cycle time are recorded.
+ */
+void caliPileCaptureWriter::begin(const caliPile &sensor) {
+    caliPileCalibration cal = sensor.calibration();
+    uint8_t data[CAPTURE_HEADER_LENGTH];
+    uint8_t *item = &data[1];
+
+    data[0] = CAPTURE_SYNC;
+    item[0] = CAPTURE_TYPE_HEADER | streamId;
+    item[1] = 'C';
+    item[2] = 'P';
+    item[3] = CAPTURE_VERSION;
+    item[4] = sensor.address();
+    putU16(&item[5], sensor.cycleTimeMs());
+    putU16(&item[7], cal.PTAT25);
+    putU16(&item[9], cal.M);
+    putU16(&item[11], cal.U0);
+    putU32(&item[13], cal.UOUT1);
+    item[17] = cal.TOBJ1;
+    item[18] = cal.lookup;
+    putU16(&item[19], cal.checksum);
+    putF32(&item[21], cal.k);
+    putF32(&item[25], sensor.exponent());
+
+    finish(data, CAPTURE_HEADER_LENGTH);
+    sinceKey = 0;
+}
+
+/**
+ * @brief Writes one sample.
+ * 
+ * @param timestamp The time the snapshot was read, in ms (e.g. millis()).
+ * @param snapshot The snapshot to record.
+ */
+void caliPileCaptureWriter::write(uint32_t timestamp, const caliPileSnapshot &snapshot) {
+    caliPileCaptureSample next;
+    next.stream = streamId;
+    next.chipStatus = snapshot.chipStatus();
+    next.timestamp = timestamp;
+    next.objectTemp = snapshot.objectTemp();
+    next.ambientTemp = snapshot.ambientTemp();
+    next.objectTempLP1Raw = snapshot.objectTempLP1Raw();
+    next.objectTempLP2Raw = snapshot.objectTempLP2Raw();
+
+    uint32_t dt = timestamp - last.timestamp;
+    int32_t dObject = (int32_t) (next.objectTemp - last.objectTemp);
+    int32_t dAmbient = (int32_t) next.ambientTemp - (int32_t) last.ambientTemp;
+    int32_t dLP1 = (int32_t) (next.objectTempLP1Raw - last.objectTempLP1Raw);
+    int32_t dLP2 = (int32_t) (next.objectTempLP2Raw - last.objectTempLP2Raw);
+
+    uint8_t data[CAPTURE_KEY_LENGTH];
+    uint8_t *item = &data[1];
+    data[0] = CAPTURE_SYNC;
+    item[1] = next.chipStatus;
+    if (sinceKey == 0 || dt > 0xFF || !fitsInt16(dObject) || !fitsInt8(dAmbient) || !fitsInt16(dLP1) || !fitsInt16(dLP2)) {
+        item[0] = CAPTURE_TYPE_KEY | streamId;
+        putU32(&item[2], next.timestamp);
+        putU24(&item[6], next.objectTemp);
+        putU16(&item[9], next.ambientTemp);
+        putU24(&item[11], next.objectTempLP1Raw);
+        putU24(&item[14], next.objectTempLP2Raw);
+        finish(data, CAPTURE_KEY_LENGTH);
+        sinceKey = CAPTURE_KEY_INTERVAL;
+    } else {
+        item[0] = CAPTURE_TYPE_DELTA | streamId;
+        item[2] = dt;
+        putU16(&item[3], dObject);
+        item[5] = dAmbient;
+        putU16(&item[6], dLP1);
+        putU16(&item[8], dLP2);
+        finish(data, CAPTURE_DELTA_LENGTH);
+    }
+    sinceKey--;
+    last = next;
+}
+
+/**
+ * @brief Appends the CRC to an item and writes it.
+ * 
+ * @param data The item, starting with the sync byte, with room for the CRC.
+ * @param length The length of the item including sync byte and CRC.
+ */
+void caliPileCaptureWriter::finish(uint8_t *data, uint8_t length) {
+    data[length - 1] = caliPileCaptureCrc8(&data[1], length - 2);
+    written += out.write(data, length);
+}
+
+/**
+ * @brief Returns the number of bytes written so far, headers included.
+ * 
+ * @return The byte count.
+ */
+uint32_t caliPileCaptureWriter::bytesWritten() const {
+    return written;
+}
@@ -0,0 +1,36 @@
+#ifndef caliPileCapture_h
+#define caliPileCapture_h
+
+#include "caliPile.h"
+#include "caliPileCaptureFormat.h"
+
+/**
+ * @brief Streams snapshots in the binary capture format to a Print.
+ *
+ * A delta sample takes CAPTURE_DELTA_LENGTH (12) bytes and a key sample
+ * CAPTURE_KEY_LENGTH (19), where the same values as text take about 35
+ * characters. One sample per 30 ms with a key every CAPTURE_KEY_INTERVAL
+ * samples is about 400 bytes/s, so a 115200 baud link (11520 bytes/s) carries
+ * all 16 streams at that rate, about 6.5 kbytes/s, and still 10.1 kbytes/s
+ * if every sample were a key; as text it would fit 9 sensors. Give every
+ * sensor sharing a link its own stream number. See caliPileCaptureFormat.h
+ * for the layout and caliPileCaptureReader for decoding on the host.
+ */
+class caliPileCaptureWriter {
+public:
+    caliPileCaptureWriter(Print &output, uint8_t stream = 0);
+    void begin(const caliPile &sensor);
+    void write(uint32_t timestamp, const caliPileSnapshot &snapshot);
+    uint32_t bytesWritten() const;
+
+private:
+    Print &out;
+    uint8_t streamId;
+    uint8_t sinceKey;
+    uint32_t written;
+    caliPileCaptureSample last;
+
+    void finish(uint8_t *data, uint8_t length);
+};
+
+#endif
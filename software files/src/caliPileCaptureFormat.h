@@ -0,0 +1,129 @@
+#ifndef caliPileCaptureFormat_h
+#define caliPileCaptureFormat_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Binary capture format written by caliPileCaptureWriter.
+ *
+ * A capture is a sequence of items. Every item starts with the sync byte
+ * CAPTURE_SYNC and ends with a CRC-8 (polynomial 0x07, initial value 0) over
+ * the bytes between them. The item byte after the sync byte holds the item
+ * type in bits 7..6 and the stream (sensor) number in bits 3..0, so up to 16
+ * sensors can share one link; bits 5..4 are reserved and zero. Multi-byte
+ * fields are little-endian.
+ *
+ * Header (CAPTURE_HEADER_LENGTH bytes), once per stream before its samples:
+ *   sync, item, 'C', 'P', version, address, cycle ms (u16), PTAT25 (u16),
+ *   M (u16), U0 (u16), UOUT1 (u32), TOBJ1, LOOKUP#, checksum (u16), k (f32),
+ *   exponent (f32), CRC
+ * Key sample (CAPTURE_KEY_LENGTH bytes), absolute values:
+ *   sync, item, CHIP_STATUS, timestamp ms (u32), TPOBJECT (u24),
+ *   TPAMBIENT (u16), TPOBJLP1 (u24), TPOBJLP2 (u24), CRC
+ * Delta sample (CAPTURE_DELTA_LENGTH bytes), differences to the previous
+ * sample of the stream:
+ *   sync, item, CHIP_STATUS, timestamp (u8), TPOBJECT (i16), TPAMBIENT (i8),
+ *   TPOBJLP1 (i16), TPOBJLP2 (i16), CRC
+ *
+ * TPOBJECT and TPAMBIENT are the counts returned by the caliPileSnapshot
+ * accessors. TPOBJLP1 and TPOBJLP2 are the 20-bit register fields
+ * (objectTempLP1Raw(), objectTempLP2Raw()), before the division by 8 of the
+ * accessors, so no bits are lost; caliPileCaptureSample decodes them on
+ * read. A key sample is written whenever a difference does not fit and at
+ * least every CAPTURE_KEY_INTERVAL samples.
+ *
+ * The sync byte may also occur inside an item, so a reader that starts in
+ * the middle of a capture or lost bytes on the link takes an item only if
+ * its reserved bits are clear and its CRC matches; otherwise it moves on to
+ * the next sync byte. A delta can only be applied to the sample before it,
+ * so after any dropped byte every stream waits for its next key sample, at
+ * most CAPTURE_KEY_INTERVAL samples later. Temperatures further need the
+ * stream's header, which the writer sends only from begin().
+ */
+
+#define CAPTURE_VERSION 3
+#define CAPTURE_MAX_STREAMS 16
+#define CAPTURE_KEY_INTERVAL 64
+#define CAPTURE_SYNC 0xA5
+
+#define CAPTURE_TYPE_DELTA 0x00
+#define CAPTURE_TYPE_KEY 0x40
+#define CAPTURE_TYPE_HEADER 0x80
+#define CAPTURE_TYPE_MASK 0xC0
+#define CAPTURE_RESERVED_MASK 0x30
+#define CAPTURE_STREAM_MASK 0x0F
+
+#define CAPTURE_HEADER_LENGTH 31
+#define CAPTURE_KEY_LENGTH 19
+#define CAPTURE_DELTA_LENGTH 12
+
+// Results of caliPileCaptureReader::decode()
+#define CAPTURE_NEED_MORE 0
+#define CAPTURE_HEADER 1
+#define CAPTURE_SAMPLE 2
+#define CAPTURE_SKIPPED 3
+
+uint8_t caliPileCaptureCrc8(const uint8_t *data, size_t length);
+
+/**
+ * @brief Stream header: the sensor's identity and calibration constants.
+ */
+struct caliPileCaptureHeader {
+    uint8_t stream;
+    uint8_t version;
+    uint8_t address;
+    uint16_t cycleMs;
+    uint16_t PTAT25, M, U0;
+    uint32_t UOUT1;
+    uint8_t TOBJ1;
+    uint8_t lookup;
+    uint16_t checksum;
+    float k;
+    float exponent;
+};
+
+/**
+ * @brief One decoded sample with absolute values.
+ *
+ * The LP1 and LP2 fields hold the 20-bit register values; the accessors
+ * return the counts of the caliPileSnapshot accessors.
+ */
+struct caliPileCaptureSample {
+    uint8_t stream;
+    uint8_t chipStatus;
+    uint32_t timestamp;
+    uint32_t objectTemp;
+    uint16_t ambientTemp;
+    uint32_t objectTempLP1Raw;
+    uint32_t objectTempLP2Raw;
+
+    uint32_t objectTempLP1() const { return objectTempLP1Raw / 8; }
+    uint32_t objectTempLP2() const { return objectTempLP2Raw / 8; }
+};
+
+/**
+ * @brief Incremental decoder for captures, usable on the host.
+ *
+ * Works on any byte buffer: a memory-mapped file, or chunks read from a
+ * serial port where the unconsumed tail is carried over to the next call.
+ * Needs only <stdint.h>, so it builds without the Arduino core.
+ */
+class caliPileCaptureReader {
+public:
+    caliPileCaptureReader();
+    void reset();
+    uint8_t decode(const uint8_t *data, size_t length, size_t &consumed);
+    bool hasHeader(uint8_t stream) const;
+    const caliPileCaptureHeader &header(uint8_t stream) const;
+    const caliPileCaptureSample &sample() const;
+
+private:
+    caliPileCaptureHeader headers[CAPTURE_MAX_STREAMS];
+    caliPileCaptureSample last[CAPTURE_MAX_STREAMS];
+    uint16_t headerSeen;
+    uint16_t keySeen;
+    uint8_t current;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include <string.h>
+#include "caliPileCaptureFormat.h"
+
+static uint16_t readU16(const uint8_t *data) {
+    return (uint16_t) data[0] | ((uint16_t) data[1] << 8);
+}
+
+static uint32_t readU24(const uint8_t *data) {
+    return (uint32_t) data[0] | ((uint32_t) data[1] << 8) | ((uint32_t) data[2] << 16);
+}
+
+static uint32_t readU32(const uint8_t *data) {
+    return readU24(data) | ((uint32_t) data[3] << 24);
+}
+
+static float readF32(const uint8_t *data) {
+    uint32_t bits = readU32(data);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Computes the CRC-8 that ends every capture item.
+ * 
+ * @param data The bytes between the sync byte and the CRC.
+ * @param length The number of bytes.
+ * @return The CRC-8 with polynomial 0x07 and initial value 0.
+ */
+uint8_t caliPileCaptureCrc8(const uint8_t *data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t) ((crc << 1) ^ 0x07) : (uint8_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Constructor for the caliPileCaptureReader class.
+ */
+caliPileCaptureReader::caliPileCaptureReader() {
+    reset();
+}
+
+/**
+ * @brief Forgets all headers and previous samples, e.g. before a new capture.
+ */
+void caliPileCaptureReader::reset() {
+    memset(headers, 0, sizeof(headers));
+    memset(last, 0, sizeof(last));
+    headerSeen = 0;
+    keySeen = 0;
+    current = 0;
+}
+
+/**
+ * @brief Decodes the next item of a capture.
+ * 
+ * Call repeatedly, advancing data by consumed each time. Bytes up to the
+ * next CAPTURE_SYNC are skipped, and so is a sync byte that starts no item
+ * with clear reserved bits and a matching CRC, which lets the reader
+ * resynchronize after line noise or when started mid-capture. Since a lost
+ * item may have been a delta, skipping bytes makes every stream wait for
+ * its next key sample; delta samples before it are skipped as well.
+ * 
+ * @param data The bytes still to be decoded.
+ * @param length The number of bytes available.
+ * @param consumed Output, the number of bytes used by this call.
+ * @return CAPTURE_HEADER or CAPTURE_SAMPLE when header() or sample() holds a
+ *         new item, CAPTURE_SKIPPED if bytes were dropped, CAPTURE_NEED_MORE
+ *         if the next item is incomplete (consumed is then 0).
+ */
+uint8_t caliPileCaptureReader::decode(const uint8_t *data, size_t length, size_t &consumed) {
+    consumed = 0;
+    if (length == 0) {
+        return CAPTURE_NEED_MORE;
+    }
+    if (data[0] != CAPTURE_SYNC) {
+        const void *sync = memchr(data, CAPTURE_SYNC, length);
+        consumed = sync ? (size_t) ((const uint8_t *) sync - data) : length;
+        keySeen = 0;
+        return CAPTURE_SKIPPED;
+    }
+    if (length < 2) {
+        return CAPTURE_NEED_MORE;
+    }
+
+    const uint8_t *item = &data[1];
+    uint8_t type = item[0] & CAPTURE_TYPE_MASK;
+    uint8_t stream = item[0] & CAPTURE_STREAM_MASK;
+    uint16_t bit = (uint16_t) 1 << stream;
+    size_t itemLength = 0;
+    if (type == CAPTURE_TYPE_HEADER) {
+        itemLength = CAPTURE_HEADER_LENGTH;
+    } else if (type == CAPTURE_TYPE_KEY) {
+        itemLength = CAPTURE_KEY_LENGTH;
+    } else if (type == CAPTURE_TYPE_DELTA) {
+        itemLength = CAPTURE_DELTA_LENGTH;
+    }
+    if (itemLength == 0 || (item[0] & CAPTURE_RESERVED_MASK)) {
+        consumed = 1;
+        keySeen = 0;
+        return CAPTURE_SKIPPED;
+    }
+    if (length < itemLength) {
+        return CAPTURE_NEED_MORE;
+    }
+    if (caliPileCaptureCrc8(item, itemLength - 2) != data[itemLength - 1]) {
+        consumed = 1;
+        keySeen = 0;
+        return CAPTURE_SKIPPED;
+    }
+    consumed = itemLength;
+
+    if (type == CAPTURE_TYPE_HEADER) {
+        if (item[1] != 'C' || item[2] != 'P' || item[3] != CAPTURE_VERSION) {
+            return CAPTURE_SKIPPED;
+        }
+        caliPileCaptureHeader &h = headers[stream];
+        h.stream = stream;
+        h.version = item[3];
+        h.address = item[4];
+        h.cycleMs = readU16(&item[5]);
+        h.PTAT25 = readU16(&item[7]);
+        h.M = readU16(&item[9]);
+        h.U0 = readU16(&item[11]);
+        h.UOUT1 = readU32(&item[13]);
+        h.TOBJ1 = item[17];
+        h.lookup = item[18];
+        h.checksum = readU16(&item[19]);
+        h.k = readF32(&item[21]);
+        h.exponent = readF32(&item[25]);
+        headerSeen |= bit;
+        keySeen &= ~bit;
+        current = stream;
+        return CAPTURE_HEADER;
+    }
+
+    if (type == CAPTURE_TYPE_KEY) {
+        caliPileCaptureSample &s = last[stream];
+        s.stream = stream;
+        s.chipStatus = item[1];
+        s.timestamp = readU32(&item[2]);
+        s.objectTemp = readU24(&item[6]);
+        s.ambientTemp = readU16(&item[9]);
+        s.objectTempLP1Raw = readU24(&item[11]);
+        s.objectTempLP2Raw = readU24(&item[14]);
+        keySeen |= bit;
+        current = stream;
+        return CAPTURE_SAMPLE;
+    }
+
+    if (!(keySeen & bit)) {
+        return CAPTURE_SKIPPED;
+    }
+    caliPileCaptureSample &s = last[stream];
+    s.chipStatus = item[1];
+    s.timestamp += item[2];
+    s.objectTemp += (int16_t) readU16(&item[3]);
+    s.ambientTemp += (int8_t) item[5];
+    s.objectTempLP1Raw += (int16_t) readU16(&item[6]);
+    s.objectTempLP2Raw += (int16_t) readU16(&item[8]);
+    current = stream;
+    return CAPTURE_SAMPLE;
+}
+
+/**
+ * @brief Tells whether a header has been decoded for a stream.
+ * 
+ * @param stream The stream number, 0..CAPTURE_MAX_STREAMS - 1.
+ * @return true once the stream's header has been seen.
+ */
+bool caliPileCaptureReader::hasHeader(uint8_t stream) const {
+    return headerSeen & ((uint16_t) 1 << (stream & CAPTURE_STREAM_MASK));
+}
+
+/**
+ * @brief Returns the last header decoded for a stream.
+ * 
+ * @param stream The stream number, 0..CAPTURE_MAX_STREAMS - 1.
+ * @return The header, all zero if none has been seen.
+ */
+const caliPileCaptureHeader &caliPileCaptureReader::header(uint8_t stream) const {
+    return headers[stream & CAPTURE_STREAM_MASK];
+}
+
+/**
+ * @brief Returns the sample decoded by the last call to decode().
+ * 
+ * @return The sample with absolute values.
+ */
+const caliPileCaptureSample &caliPileCaptureReader::sample() const {
+    return last[current];
+}
@@ -0,0 +1,196 @@
+#include <string.h>
+#include "caliPileEmulator.h"
+
+/**
+ * @brief Constructor for the caliPileEmulator class.
+ * 
+ * Starts with all configuration registers zero, like the sensor after power-up.
+ */
+caliPileEmulator::caliPileEmulator() {
+    memset(config, 0, sizeof(config));
+    updateShifts();
+    reset();
+}
+
+/**
+ * @brief Clears the filters and flags, keeping the configuration.
+ * 
+ * The next step() seeds every filter with its input, so recordings can be
+ * replayed without waiting for the long time constants to settle.
+ */
+void caliPileEmulator::reset() {
+    seeded = false;
+    lp1 = lp2 = lp3 = 0;
+    memset(historyLP1, 0, sizeof(historyLP1));
+    historyIndex = 0;
+    latched = 0;
+    memset(&out, 0, sizeof(out));
+}
+
+/**
+ * @brief Sets a configuration register, as caliPile::setConfig() does on the sensor.
+ * 
+ * @param reg A register between SLP12 and TPOT_THR + 1.
+ * @param value The register value.
+ */
+void caliPileEmulator::setRegister(uint8_t reg, uint8_t value) {
+    if (reg < SLP12 || reg >= SLP12 + CONFIG_LENGTH) {
+        return;
+    }
+    config[reg - SLP12] = value;
+    updateShifts();
+}
+
+/**
+ * @brief Sets all configuration registers at once.
+ * 
+ * @param registers CONFIG_LENGTH bytes from SLP12 on, e.g. from caliPile::configValue().
+ */
+void caliPileEmulator::configure(const uint8_t *registers) {
+    memcpy(config, registers, CONFIG_LENGTH);
+    updateShifts();
+}
+
+/**
+ * @brief Runs one conversion.
+ * 
+ * @param objectTemp The TPOBJECT counts of this conversion.
+ * @param ambientTemp The TPAMBIENT counts of this conversion.
+ * @return The filter outputs and detector values after this conversion.
+ */
+const caliPileEmulatorState &caliPileEmulator::step(uint32_t objectTemp, uint16_t ambientTemp) {
+    const int32_t half = 1 << (EMULATOR_FRACTION_BITS - 1);
+    int32_t object = (int32_t) objectTemp << EMULATOR_FRACTION_BITS;
+    int32_t ambient = (int32_t) ambientTemp << EMULATOR_FRACTION_BITS;
+
+    if (!seeded) {
+        lp1 = lp2 = object;
+        lp3 = ambient;
+        for (uint8_t i = 0; i < EMULATOR_MOTION_HISTORY; i++) {
+            historyLP1[i] = objectTemp;
+        }
+        out.objectTempLP2Frozen = objectTemp;
+        seeded = true;
+    } else {
+        lp1 += (object - lp1) >> shiftLP1;
+        lp2 += (object - lp2) >> shiftLP2;
+        lp3 += (ambient - lp3) >> shiftLP3;
+    }
+
+    uint8_t status = out.chipStatus & (INT_PRESENCE | INT_MOTION | INT_AMB_SHOCK | INT_TPOT);
+    out.objectTempLP1 = (lp1 + half) >> EMULATOR_FRACTION_BITS;
+    out.objectTempLP2 = (lp2 + half) >> EMULATOR_FRACTION_BITS;
+    out.ambientTempLP3 = (lp3 + half) >> EMULATOR_FRACTION_BITS;
+
+    // The LP1 value one cycle time ago
+    uint8_t span = 1 << (config[SRC_SELECT - SLP12] & 0x03);
+    uint32_t pastLP1 = historyLP1[(historyIndex + EMULATOR_MOTION_HISTORY - span) % EMULATOR_MOTION_HISTORY];
+    int32_t motion = (int32_t) out.objectTempLP1 - (int32_t) pastLP1;
+    historyLP1[historyIndex] = out.objectTempLP1;
+    historyIndex = (historyIndex + 1) % EMULATOR_MOTION_HISTORY;
+    uint8_t motionFlag = compare(motion, config[TP_MOT_THLD - SLP12], status & INT_MOTION, out.motionStat);
+    if (!motionFlag) {
+        out.objectTempLP2Frozen = out.objectTempLP2;
+    }
+
+    uint8_t source = (config[SRC_SELECT - SLP12] >> 2) & 0x03;
+    int32_t minuend = (source & 0x01) ? (int32_t) out.objectTempLP1 : (int32_t) objectTemp;
+    int32_t subtrahend = (source & 0x02) ? (int32_t) out.objectTempLP2Frozen : (int32_t) out.objectTempLP2;
+    int32_t presence = minuend - subtrahend;
+    uint8_t presenceFlag = compare(presence, config[TP_PRES_THLD - SLP12], status & INT_PRESENCE, out.presenceStat);
+
+    int32_t shock = (int32_t) ambientTemp - (int32_t) out.ambientTempLP3;
+    uint8_t shockFlag = compare(shock, config[TP_AMB_SHOCK_THLD - SLP12], status & INT_AMB_SHOCK, out.ambientShockStat);
+
+    int32_t limit = 2 * ((int32_t) config[TPOT_THR - SLP12] << 8 | config[TPOT_THR + 1 - SLP12]);
+    bool below = config[SRC_SELECT - SLP12] & 0x10;
+    int32_t excess = below ? limit - (int32_t) objectTemp : (int32_t) objectTemp - limit;
+    uint8_t tpotFlag = limit && (excess > 0 || ((status & INT_TPOT) && excess > -EMULATOR_TPOT_HYSTERESIS));
+
+    uint8_t flags = (presenceFlag ? INT_PRESENCE : 0) | (motionFlag ? INT_MOTION : 0) | (shockFlag ? INT_AMB_SHOCK : 0) | (tpotFlag ? INT_TPOT : 0);
+    out.chipStatus = flags | (presence < 0 ? SIGN_PRESENCE : 0) | (motion < 0 ? SIGN_MOTION : 0) | (shock < 0 ? SIGN_AMB_SHOCK : 0);
+
+    // Like the sensor, only a flag going active raises an interrupt
+    uint8_t raised = flags & ~status & config[INT_MASK - SLP12];
+    if (raised) {
+        latched = (latched & 0x1F) | raised | (out.chipStatus & (SIGN_PRESENCE | SIGN_MOTION | SIGN_AMB_SHOCK));
+    }
+    return out;
+}
+
+/**
+ * @brief Returns the outputs of the last step().
+ * 
+ * @return The filter outputs and detector values.
+ */
+const caliPileEmulatorState &caliPileEmulator::state() const {
+    return out;
+}
+
+/**
+ * @brief Reads and clears the latched interrupt status, as reading INTERRUPT_STATUS does.
+ * 
+ * @return The flags raised since the last call, with the signs at the latest event.
+ */
+uint8_t caliPileEmulator::interruptStatus() {
+    uint8_t status = latched;
+    latched = 0;
+    return status;
+}
+
+/**
+ * @brief Derives the filter coefficients from SLP12 and SLP3.
+ */
+void caliPileEmulator::updateShifts() {
+    shiftLP1 = filterShift(config[SLP12 - SLP12] & 0x0F);
+    shiftLP2 = filterShift(config[SLP12 - SLP12] >> 4);
+    shiftLP3 = filterShift(config[SLP3 - SLP12] & 0x0F);
+}
+
+/**
+ * @brief Returns n so that 2^-n is the closest filter coefficient to conversion interval / time constant.
+ * 
+ * @param code The LP_* select code.
+ * @return The right shift applied in the filter update.
+ */
+uint8_t caliPileEmulator::filterShift(uint8_t code) {
+    uint32_t tau;
+    if (code <= LP_16s) {
+        tau = 512000UL >> code;
+    } else if (code < LP_8s) {
+        tau = 16000UL;
+    } else if (code <= LP_0_25s) {
+        tau = 8000UL >> (code - LP_8s);
+    } else {
+        tau = 250UL;
+    }
+    uint64_t interval = EMULATOR_CONVERSION_MS;
+    uint8_t n = 0;
+    // 2^n < ratio / sqrt(2) rounds log2(ratio) to the nearest integer
+    while ((uint64_t) tau * tau >= 2 * (interval << n) * (interval << n)) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Applies a threshold with hysteresis to a detector value.
+ * 
+ * @param value The signed difference.
+ * @param threshold The threshold register value.
+ * @param active Whether the flag was set after the previous cycle.
+ * @param magnitude Output, the value as stored in the 8 bit result register.
+ * @return 1 if the flag is set after this cycle, otherwise 0.
+ */
+uint8_t caliPileEmulator::compare(int32_t value, uint8_t threshold, bool active, uint8_t &magnitude) {
+    uint32_t size = value < 0 ? -value : value;
+    magnitude = size > 0xFF ? 0xFF : size;
+    uint32_t hysteresis = threshold / 8;
+    if (hysteresis < EMULATOR_HYSTERESIS_MIN) {
+        hysteresis = EMULATOR_HYSTERESIS_MIN;
+    }
+    if (size > threshold) {
+        return 1;
+    }
+    return active && size + hysteresis >= threshold;
+}
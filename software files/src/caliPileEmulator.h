@@ -0,0 +1,89 @@
+#ifndef caliPileEmulator_h
+#define caliPileEmulator_h
+
+#include <stdint.h>
+#include "caliPileRegisters.h"
+
+// Fractional bits kept in the filter states
+#define EMULATOR_FRACTION_BITS 8
+// Interval of the sensor's conversions at the nominal oscillator, in milliseconds
+#define EMULATOR_CONVERSION_MS 30
+// LP1 values kept for motion, the longest cycle time in conversions
+#define EMULATOR_MOTION_HISTORY 8
+// Hysteresis of the presence, motion and ambient shock comparators
+#define EMULATOR_HYSTERESIS_MIN 5
+// Fixed hysteresis of the TPOT comparator, in TPOBJECT counts
+#define EMULATOR_TPOT_HYSTERESIS 64
+
+/**
+ * @brief Outputs of one emulated conversion cycle.
+ *
+ * Fields follow the caliPileSnapshot accessors: filter outputs in TPOBJECT
+ * (TPAMBIENT for LP3) counts, detector values as magnitudes with the signs
+ * and flags in chipStatus, as in CHIP_STATUS.
+ */
+struct caliPileEmulatorState {
+    uint32_t objectTempLP1;
+    uint32_t objectTempLP2;
+    uint32_t objectTempLP2Frozen;
+    uint16_t ambientTempLP3;
+    uint8_t presenceStat;
+    uint8_t motionStat;
+    uint8_t ambientShockStat;
+    uint8_t chipStatus;
+};
+
+/**
+ * @brief Streaming model of the on-chip filters and detectors.
+ *
+ * Feed it the TPOBJECT and TPAMBIENT counts of every conversion, one
+ * step() per EMULATOR_CONVERSION_MS, e.g. from a capture, and it produces LP1, LP2, LP2 frozen, LP3 and the presence,
+ * motion, ambient shock and TPOT flags for the configuration set through
+ * setRegister(). A step is a few integer operations, so hours of recorded
+ * data replay in milliseconds on a host and filter and threshold choices can
+ * be compared offline. Needs only <stdint.h>.
+ *
+ * The model follows the data sheet description:
+ *  - LP(x) = LP(x-1) + (in - LP(x-1)) * s with s = 2^-n, the power of two
+ *    closest to conversion interval / time constant of the SLP12 and SLP3
+ *    codes. The filters run at the conversion rate whatever the cycle time.
+ *  - Presence is the SRC_SELECT pair (TPOBJ or LP1 minus LP2 or LP2 frozen).
+ *  - Motion is the change of LP1 over the SRC_SELECT cycle time, i.e. 1, 2,
+ *    4 or 8 conversions back.
+ *  - Ambient shock is TPAMBIENT minus LP3.
+ *  - A flag sets above its threshold and clears below the threshold minus
+ *    the hysteresis (12.5 % of the threshold, at least 5 counts).
+ *  - LP2 frozen follows LP2 and holds while motion is flagged.
+ *  - TPOT compares TPOBJECT with twice TPOT_THR, 64 counts hysteresis.
+ *
+ * The chip's internal word lengths and rounding are not published, so the
+ * outputs track the sensor closely but are not bit-identical to it; compare
+ * with the emulator example before relying on absolute values.
+ */
+class caliPileEmulator {
+public:
+    caliPileEmulator();
+    void reset();
+    void setRegister(uint8_t reg, uint8_t value);
+    void configure(const uint8_t *registers);
+    const caliPileEmulatorState &step(uint32_t objectTemp, uint16_t ambientTemp);
+    const caliPileEmulatorState &state() const;
+    uint8_t interruptStatus();
+
+private:
+    uint8_t config[CONFIG_LENGTH];
+    uint8_t shiftLP1, shiftLP2, shiftLP3;
+    bool seeded;
+    int32_t lp1, lp2, lp3;
+    // The last EMULATOR_MOTION_HISTORY LP1 outputs, a ring
+    uint32_t historyLP1[EMULATOR_MOTION_HISTORY];
+    uint8_t historyIndex;
+    uint8_t latched;
+    caliPileEmulatorState out;
+
+    void updateShifts();
+    static uint8_t filterShift(uint8_t code);
+    static uint8_t compare(int32_t value, uint8_t threshold, bool active, uint8_t &magnitude);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include "caliPileEvents.h"
+
+/**
+ * @brief Constructor for the caliPileEventQueue class.
+ * 
+ * @param eventSensor The sensor whose INT pin feeds this queue.
+ */
+caliPileEventQueue::caliPileEventQueue(caliPile &eventSensor) : sensor(eventSensor), head(0), tail(0), overflows(0) {
+}
+
+/**
+ * @brief Queues an interrupt of the sensor.
+ * 
+ * Call this from the ISR attached to the INT pin. It does not touch the bus.
+ * If the queue is full the interrupt is counted in dropped() instead; the
+ * status flags are still latched by the sensor and delivered with the next
+ * serviced event.
+ */
+void caliPileEventQueue::onInterrupt() {
+    uint8_t next = (head + 1) & (EVENT_QUEUE_SIZE - 1);
+    if (next == tail) {
+        overflows++;
+        return;
+    }
+    timestamps[head] = micros();
+    head = next;
+}
+
+/**
+ * @brief Delivers the queued interrupts as one event.
+ * 
+ * Call this from loop(). The latched status and the presence, motion and
+ * ambient shock values are read in one transaction. The event gets the
+ * timestamp of the oldest queued interrupt, and every interrupt queued
+ * before the read is consumed with it. Interrupts that latched no status,
+ * e.g. an edge already served by the previous read, are consumed without an
+ * event. If the read fails the queue is kept for the next call.
+ * 
+ * @param handler The function receiving the event.
+ * @return The number of events delivered, 0 or 1.
+ */
+uint8_t caliPileEventQueue::service(caliPileEventHandler handler) {
+    uint8_t last = head;
+    if (tail == last) {
+        return 0;
+    }
+    uint8_t rawData[4] = {0, 0, 0, 0};
+    if (sensor.readRegisters(sensor.address(), TPPRESENCE, 4, &rawData[0]) != BUS_OK) {
+        return 0;
+    }
+
+    caliPileEvent event;
+    event.timestamp = timestamps[tail];
+    event.interrupts = (last - tail) & (EVENT_QUEUE_SIZE - 1);
+    event.presence = rawData[TPPRESENCE - TPPRESENCE];
+    event.motion = rawData[TPMOTION - TPPRESENCE];
+    event.ambientShock = rawData[TPAMB_SHOCK - TPPRESENCE];
+    event.status = rawData[INTERRUPT_STATUS - TPPRESENCE];
+    tail = last;
+
+    if (event.status == 0) {
+        return 0;
+    }
+    handler(event);
+    return 1;
+}
+
+/**
+ * @brief Returns the number of interrupts waiting for service().
+ * 
+ * @return The number of queued interrupts.
+ */
+uint8_t caliPileEventQueue::pending() const {
+    return (head - tail) & (EVENT_QUEUE_SIZE - 1);
+}
+
+/**
+ * @brief Returns the number of interrupts that found the queue full.
+ * 
+ * @return The number of dropped interrupts.
+ */
+uint16_t caliPileEventQueue::dropped() const {
+    return overflows;
+}
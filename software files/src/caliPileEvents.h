@@ -0,0 +1,61 @@
+#ifndef caliPileEvents_h
+#define caliPileEvents_h
+
+#include "caliPile.h"
+
+// Interrupts that can wait for service() at once, must be a power of two
+#define EVENT_QUEUE_SIZE 8
+
+/**
+ * @brief One serviced interrupt of the sensor.
+ *
+ * status holds INTERRUPT_STATUS as latched since the previous event, so it
+ * carries every condition that fired in between (INT_* flags, SIGN_* bits).
+ * timestamp is the time of the oldest interrupt folded into the event and
+ * interrupts the number of INT pin interrupts it stands for.
+ */
+struct caliPileEvent {
+    uint32_t timestamp;
+    uint8_t interrupts;
+    uint8_t status;
+    uint8_t presence;
+    uint8_t motion;
+    uint8_t ambientShock;
+
+    bool isPresence() const { return status & INT_PRESENCE; }
+    bool isMotion() const { return status & INT_MOTION; }
+    bool isAmbientShock() const { return status & INT_AMB_SHOCK; }
+    bool isOverTemp() const { return status & INT_TPOT; }
+    bool isTimer() const { return status & INT_TIMER; }
+};
+
+typedef void (*caliPileEventHandler)(const caliPileEvent &event);
+
+/**
+ * @brief Interrupt driven event pipeline for one sensor.
+ *
+ * onInterrupt() is called from the INT pin ISR and only stores a timestamp in
+ * a single-producer/single-consumer ring. service() is called from loop(); if
+ * interrupts are queued it reads TPPRESENCE..INTERRUPT_STATUS once, in one
+ * burst (which clears the latched status and releases the INT pin), and hands
+ * the result to the handler as one event. INTERRUPT_STATUS clears on read, so
+ * a second read would find nothing: every interrupt queued before the read is
+ * folded into that event. While nothing happens there is no bus traffic.
+ */
+class caliPileEventQueue {
+public:
+    caliPileEventQueue(caliPile &eventSensor);
+    void onInterrupt();
+    uint8_t service(caliPileEventHandler handler);
+    uint8_t pending() const;
+    uint16_t dropped() const;
+
+private:
+    caliPile &sensor;
+    volatile uint32_t timestamps[EVENT_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint16_t overflows;
+};
+
+#endif
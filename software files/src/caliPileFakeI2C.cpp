@@ -0,0 +1,391 @@
+#include "caliPileFakeI2C.h"
+
+#ifdef CALIPILE_LINUX
+#include <errno.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+// Handle returned by the fake open()
+#define FAKE_FD 1000
+
+caliPileFakeI2C *caliPileFakeI2C::active = 0;
+
+/*
+ * EEPROM image from EEPROM_PROTOCOL to SLAVE_ADDRESS of a TPiS 1S part:
+ * PTAT25 11000, M 17200, U0 1200, UOUT1 25000, TOBJ1 100 °C. The checksum
+ * cells are filled in by addSensor(), SLAVE_ADDRESS with the address.
+ */
+static const uint8_t defaultEeprom[EEPROM_LENGTH] = {
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x2A, 0xF8, 0x43, 0x30, 0x04, 0xB0,
+    0x61, 0xA8, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/**
+ * @brief Constructor, makes this the adapter behind calls().
+ */
+caliPileFakeI2C::caliPileFakeI2C() : deviceCount(0), stuck(false), transferCount(0), busClockHz(FAKE_BUS_CLOCK_HZ),
+        loggedTransactions(0), loggedBytes(0), loggedMicros(0) {
+    active = this;
+}
+
+/**
+ * @brief Destructor, detaches calls() from this adapter.
+ */
+caliPileFakeI2C::~caliPileFakeI2C() {
+    if (active == this) {
+        active = 0;
+    }
+}
+
+/**
+ * @brief The system calls to hand to caliPileLinuxI2C.
+ * 
+ * @return open(), ioctl() and close() replacements served by the live instance.
+ */
+const caliPileI2CCalls &caliPileFakeI2C::calls() {
+    static const caliPileI2CCalls fakeCalls = {fakeOpen, fakeIoctl, fakeClose};
+    return fakeCalls;
+}
+
+/**
+ * @brief Adds a sensor with a valid EEPROM image at the given address.
+ * 
+ * @param address The 7-bit address, e.g. SENSOR_ADDRESS + 1.
+ * @return false if the address is taken or all FAKE_SENSORS slots are used.
+ */
+bool caliPileFakeI2C::addSensor(uint8_t address) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (deviceCount >= FAKE_SENSORS || address == 0 || find(address) != 0) {
+        return false;
+    }
+    device &added = devices[deviceCount++];
+    added.address = address;
+    added.pointer = 0;
+    added.reloading = false;
+    added.oscillator = FAKE_OSCILLATOR_PERCENT;
+    added.timerStart = millis();
+    memset(added.regs, 0, sizeof(added.regs));
+    memcpy(&added.regs[EEPROM_PROTOCOL], defaultEeprom, EEPROM_LENGTH);
+    added.regs[SLAVE_ADDRESS] = address;
+
+    uint16_t sum = 0;
+    for (uint8_t reg = EEPROM_PROTOCOL; reg <= SLAVE_ADDRESS; reg++) {
+        if (reg != EEPROM_CHECKSUM && reg != EEPROM_CHECKSUM + 1) {
+            sum += added.regs[reg];
+        }
+    }
+    added.regs[EEPROM_CHECKSUM] = sum >> 8;
+    added.regs[EEPROM_CHECKSUM + 1] = sum & 0xFF;
+    return true;
+}
+
+/**
+ * @brief Sets one register of a sensor, bypassing the write protection.
+ * 
+ * @param address The address of the sensor.
+ * @param reg The register, 0 to 63.
+ * @param value The new content.
+ */
+void caliPileFakeI2C::setRegister(uint8_t address, uint8_t reg, uint8_t value) {
+    std::lock_guard<std::mutex> guard(lock);
+    device *target = find(address);
+    if (target != 0 && reg < 64) {
+        target->regs[reg] = value;
+    }
+}
+
+/**
+ * @brief Reads one register of a sensor without the read side effects.
+ * 
+ * @param address The address of the sensor.
+ * @param reg The register, 0 to 63.
+ * @return The content, 0 for an unknown sensor.
+ */
+uint8_t caliPileFakeI2C::getRegister(uint8_t address, uint8_t reg) {
+    std::lock_guard<std::mutex> guard(lock);
+    device *target = find(address);
+    return target != 0 && reg < 64 ? target->regs[reg] : 0;
+}
+
+/**
+ * @brief Places raw TPOBJECT and TPAMBIENT readings in a sensor.
+ * 
+ * @param address The address of the sensor.
+ * @param objectRaw The 17-bit object reading.
+ * @param ambientRaw The 15-bit ambient reading.
+ */
+void caliPileFakeI2C::setSample(uint8_t address, uint32_t objectRaw, uint16_t ambientRaw) {
+    std::lock_guard<std::mutex> guard(lock);
+    device *target = find(address);
+    if (target == 0) {
+        return;
+    }
+    target->regs[TPOBJECT] = (objectRaw >> 9) & 0xFF;
+    target->regs[TPOBJECT + 1] = (objectRaw >> 1) & 0xFF;
+    target->regs[TPAMBIENT] = ((objectRaw & 0x01) << 7) | ((ambientRaw >> 8) & 0x7F);
+    target->regs[TPAMBIENT + 1] = ambientRaw & 0xFF;
+}
+
+/**
+ * @brief Latches interrupt flags like the detectors of a sensor do.
+ * 
+ * The flags stay in INTERRUPT_STATUS until it is read.
+ * 
+ * @param address The address of the sensor.
+ * @param flags INT_* flags and SIGN_* bits to set.
+ */
+void caliPileFakeI2C::raiseInterrupt(uint8_t address, uint8_t flags) {
+    std::lock_guard<std::mutex> guard(lock);
+    device *target = find(address);
+    if (target != 0) {
+        target->regs[INTERRUPT_STATUS] |= flags;
+    }
+}
+
+/**
+ * @brief Sets how fast a sensor's oscillator runs.
+ * 
+ * The timer period scales with 100 / percent. The datasheet allows
+ * 54..76 kHz, about 84..119 % of nominal.
+ * 
+ * @param address The address of the sensor.
+ * @param percent The frequency in percent of nominal, FAKE_OSCILLATOR_PERCENT by default.
+ */
+void caliPileFakeI2C::setOscillator(uint8_t address, uint8_t percent) {
+    std::lock_guard<std::mutex> guard(lock);
+    device *target = find(address);
+    if (target != 0 && percent != 0) {
+        target->oscillator = percent;
+    }
+}
+
+/**
+ * @brief Makes every transfer fail with ETIMEDOUT until the node is reopened.
+ * 
+ * @param stuckBus true to hold the bus.
+ */
+void caliPileFakeI2C::setStuck(bool stuckBus) {
+    std::lock_guard<std::mutex> guard(lock);
+    stuck = stuckBus;
+}
+
+/**
+ * @brief Sets the clock the logged bus time is modeled at.
+ * 
+ * @param clockHz The SCL frequency, FAKE_BUS_CLOCK_HZ by default.
+ */
+void caliPileFakeI2C::setBusClock(uint32_t clockHz) {
+    std::lock_guard<std::mutex> guard(lock);
+    busClockHz = clockHz;
+}
+
+/**
+ * @brief Clears the transaction log.
+ */
+void caliPileFakeI2C::resetLog() {
+    std::lock_guard<std::mutex> guard(lock);
+    loggedTransactions = 0;
+    loggedBytes = 0;
+    loggedMicros = 0;
+}
+
+/**
+ * @brief Counts the I2C_RDWR transfers served so far.
+ * 
+ * @return The number of transfers, failed ones included; resetLog() does not clear it.
+ */
+uint32_t caliPileFakeI2C::transfers() {
+    std::lock_guard<std::mutex> guard(lock);
+    return transferCount;
+}
+
+/**
+ * @brief Counts the START..STOP transactions since the last resetLog().
+ * 
+ * @return The number of transactions that reached the bus.
+ */
+uint32_t caliPileFakeI2C::transactions() {
+    std::lock_guard<std::mutex> guard(lock);
+    return loggedTransactions;
+}
+
+/**
+ * @brief Counts the bytes on the bus since the last resetLog().
+ * 
+ * @return The bytes clocked, address bytes included.
+ */
+uint32_t caliPileFakeI2C::bytes() {
+    std::lock_guard<std::mutex> guard(lock);
+    return loggedBytes;
+}
+
+/**
+ * @brief Sums the modeled bus time since the last resetLog().
+ * 
+ * @return The time in microseconds, each transaction rounded up.
+ */
+uint32_t caliPileFakeI2C::busMicros() {
+    std::lock_guard<std::mutex> guard(lock);
+    return loggedMicros;
+}
+
+int caliPileFakeI2C::fakeOpen(const char *path, int flags) {
+    (void) path;
+    (void) flags;
+    if (active == 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    // Reopening releases a held bus, like a recovery in the adapter driver
+    active->setStuck(false);
+    return FAKE_FD;
+}
+
+int caliPileFakeI2C::fakeIoctl(int fd, unsigned long request, void *argument) {
+    if (active == 0 || fd != FAKE_FD) {
+        errno = EBADF;
+        return -1;
+    }
+    switch (request) {
+    case I2C_TIMEOUT:
+        return 0;
+    case I2C_RDWR:
+        return active->transfer(argument);
+    default:
+        errno = ENOTTY;
+        return -1;
+    }
+}
+
+int caliPileFakeI2C::fakeClose(int fd) {
+    if (fd != FAKE_FD) {
+        errno = EBADF;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Serves one I2C_RDWR transfer.
+ * 
+ * @param data The struct i2c_rdwr_ioctl_data passed to ioctl().
+ * @return The number of messages on success, -1 with errno set otherwise.
+ */
+int caliPileFakeI2C::transfer(void *data) {
+    std::lock_guard<std::mutex> guard(lock);
+    transferCount++;
+    if (stuck) {
+        errno = ETIMEDOUT;
+        return -1;
+    }
+    for (uint8_t i = 0; i < deviceCount; i++) {
+        runTimer(devices[i]);
+    }
+    struct i2c_rdwr_ioctl_data *rdwr = (struct i2c_rdwr_ioctl_data *) data;
+    uint32_t messageBytes = 0;
+    for (uint32_t m = 0; m < rdwr->nmsgs; m++) {
+        struct i2c_msg &message = rdwr->msgs[m];
+        // The address byte goes out even if nobody acknowledges it
+        messageBytes++;
+        if (message.addr == 0) {
+            if (deviceCount == 0) {
+                logTransaction(messageBytes, m);
+                errno = ENXIO;
+                return -1;
+            }
+            messageBytes += message.len;
+            if (message.len > 0 && message.buf[0] == 0x04) {
+                for (uint8_t i = 0; i < deviceCount; i++) {
+                    memset(&devices[i].regs[SLP12], 0, TPOT_THR + 2 - SLP12);
+                    devices[i].regs[EEPROM_CONTROL] = 0;
+                    devices[i].reloading = true;
+                    devices[i].reloadedAt = millis();
+                }
+            }
+            continue;
+        }
+        device *target = find(message.addr);
+        if (target != 0 && target->reloading && millis() - target->reloadedAt < FAKE_RELOAD_MS) {
+            target = 0;
+        }
+        if (target == 0) {
+            logTransaction(messageBytes, m);
+            errno = ENXIO;
+            return -1;
+        }
+        messageBytes += message.len;
+        if (message.flags & I2C_M_RD) {
+            for (uint16_t i = 0; i < message.len; i++) {
+                uint8_t reg = target->pointer;
+                uint8_t value = target->regs[reg];
+                if (reg >= EEPROM_PROTOCOL && reg <= SLAVE_ADDRESS && target->regs[EEPROM_CONTROL] != 0x80) {
+                    value = 0;
+                }
+                if (reg == INTERRUPT_STATUS) {
+                    target->regs[INTERRUPT_STATUS] = 0;
+                }
+                message.buf[i] = value;
+                target->pointer = (reg + 1) & 0x3F;
+            }
+        } else if (message.len > 0) {
+            target->pointer = message.buf[0] & 0x3F;
+            for (uint16_t i = 1; i < message.len; i++) {
+                uint8_t reg = target->pointer;
+                if (reg >= SLP12 && reg <= EEPROM_CONTROL) {
+                    target->regs[reg] = message.buf[i];
+                }
+                if (reg == TMR_INT) {
+                    // A new period restarts the timer
+                    target->timerStart = millis();
+                }
+                target->pointer = (reg + 1) & 0x3F;
+            }
+        }
+    }
+    logTransaction(messageBytes, rdwr->nmsgs > 0 ? rdwr->nmsgs - 1 : 0);
+    return rdwr->nmsgs;
+}
+
+/**
+ * @brief Adds one transaction to the log, called with the lock held.
+ * 
+ * @param messageBytes The bytes clocked, address bytes included.
+ * @param restarts The repeated STARTs between the messages.
+ */
+void caliPileFakeI2C::logTransaction(uint32_t messageBytes, uint32_t restarts) {
+    uint32_t bits = 2 + restarts + 9 * messageBytes;
+    loggedTransactions++;
+    loggedBytes += messageBytes;
+    loggedMicros += (bits * 1000000UL + busClockHz - 1) / busClockHz;
+}
+
+/**
+ * @brief Raises INT_TIMER for every timer period that ended, called with the lock held.
+ * 
+ * @param sensor The sensor whose timer is advanced.
+ */
+void caliPileFakeI2C::runTimer(device &sensor) {
+    unsigned long now = millis();
+    if (!(sensor.regs[INT_MASK] & INT_TIMER)) {
+        // Stopped; enabling it starts a full period
+        sensor.timerStart = now;
+        return;
+    }
+    unsigned long period = (sensor.regs[TMR_INT] + 1UL) * 30 * 100 / sensor.oscillator;
+    while (now - sensor.timerStart >= period) {
+        sensor.regs[INTERRUPT_STATUS] |= INT_TIMER;
+        sensor.timerStart += period;
+    }
+}
+
+caliPileFakeI2C::device *caliPileFakeI2C::find(uint8_t address) {
+    for (uint8_t i = 0; i < deviceCount; i++) {
+        if (devices[i].address == address) {
+            return &devices[i];
+        }
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,102 @@
+#ifndef caliPileFakeI2C_h
+#define caliPileFakeI2C_h
+
+#include "caliPileLinuxI2C.h"
+
+#ifdef CALIPILE_LINUX
+#include <mutex>
+
+// Sensors one fake adapter can hold, one per A1/A0 strapping
+#define FAKE_SENSORS 4
+// Default clock used to model the time a transfer spends on the bus
+#define FAKE_BUS_CLOCK_HZ 100000
+// Time a sensor does not answer after the general call reload
+#define FAKE_RELOAD_MS 10
+// Oscillator of a new sensor in percent of the nominal frequency
+#define FAKE_OSCILLATOR_PERCENT 100
+
+/**
+ * @brief Emulated i2c-dev adapter with sensors on it, for hosts without I2C hardware.
+ *
+ * Hand calls() to caliPileLinuxI2C in place of the system calls. Each
+ * sensor has the 64 byte register map: the pointer auto-increments,
+ * SLP12 to EEPROM_CONTROL are writable, the EEPROM (EEPROM_PROTOCOL to
+ * SLAVE_ADDRESS) reads as 0 unless EEPROM_CONTROL holds 0x80 and
+ * INTERRUPT_STATUS clears when read. Absent
+ * addresses answer with ENXIO like a NACK. setStuck() makes transfers time
+ * out until the node is reopened, which is what caliPileLinuxI2C::recover() does.
+ * A general call with the reload command (0x04) is acknowledged by every
+ * sensor and returns SLP12..TPOT_THR and EEPROM_CONTROL to 0; the datasheet
+ * leaves them undefined after a reload, so code must not rely on them. For
+ * FAKE_RELOAD_MS after the reload the sensors answer with a NACK.
+ *
+ * Every transfer is logged: one I2C_RDWR is one START..STOP transaction and
+ * its bus time is modeled like the CALIPILE_BUS_STATS ledger, START + 9
+ * clocks per byte with ACK + STOP, one more clock per repeated START.
+ * resetLog(), a call and transactions(), bytes() and busMicros() give the
+ * bus cost of that call.
+ *
+ * The only register that evolves by itself is INT_TIMER: while it is set
+ * in INT_MASK the timer raises it every (1 + TMR_INT) x 30 ms of millis(),
+ * scaled by the oscillator set with setOscillator(), and each transfer
+ * catches up with the periods that ended. Set the other values with
+ * setSample(), raiseInterrupt() or setRegister(). Only one instance may
+ * exist at a time.
+ */
+class caliPileFakeI2C {
+public:
+    caliPileFakeI2C();
+    ~caliPileFakeI2C();
+    static const caliPileI2CCalls &calls();
+    bool addSensor(uint8_t address);
+    void setRegister(uint8_t address, uint8_t reg, uint8_t value);
+    uint8_t getRegister(uint8_t address, uint8_t reg);
+    void setSample(uint8_t address, uint32_t objectRaw, uint16_t ambientRaw);
+    void raiseInterrupt(uint8_t address, uint8_t flags);
+    void setOscillator(uint8_t address, uint8_t percent);
+    void setStuck(bool stuck);
+    void setBusClock(uint32_t clockHz);
+    void resetLog();
+    uint32_t transfers();
+    uint32_t transactions();
+    uint32_t bytes();
+    uint32_t busMicros();
+
+private:
+    struct device {
+        uint8_t address;
+        uint8_t pointer;
+        uint8_t regs[64];
+        bool reloading;
+        unsigned long reloadedAt;
+        uint8_t oscillator;
+        // millis() when the current timer period began
+        unsigned long timerStart;
+    };
+
+    caliPileFakeI2C(const caliPileFakeI2C &);
+    caliPileFakeI2C &operator=(const caliPileFakeI2C &);
+
+    static int fakeOpen(const char *path, int flags);
+    static int fakeIoctl(int fd, unsigned long request, void *argument);
+    static int fakeClose(int fd);
+    int transfer(void *data);
+    void logTransaction(uint32_t messageBytes, uint32_t restarts);
+    device *find(uint8_t address);
+    void runTimer(device &sensor);
+
+    static caliPileFakeI2C *active;
+    std::mutex lock;
+    device devices[FAKE_SENSORS];
+    uint8_t deviceCount;
+    bool stuck;
+    uint32_t transferCount;
+    uint32_t busClockHz;
+    uint32_t loggedTransactions;
+    uint32_t loggedBytes;
+    uint32_t loggedMicros;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,173 @@
+#include "caliPileFixedPoint.h"
+
+#define ONE ((int32_t) 1 << FIXED_POINT_FRACTION_BITS)
+
+// Exponents and reciprocals of the variants in Q8.24, folded at compile time
+static const int32_t exponent1S = (int32_t) (caliPileTPiS1S::exponent() * ONE + 0.5f);
+static const int32_t reciprocal1S = (int32_t) (caliPileTPiS1S::reciprocal() * ONE + 0.5f);
+static const int32_t exponent1T = (int32_t) (caliPileTPiS1T::exponent() * ONE + 0.5f);
+static const int32_t reciprocal1T = (int32_t) (caliPileTPiS1T::reciprocal() * ONE + 0.5f);
+
+// 2^(2^-i) for i = 1..24 in Q2.30
+static const uint32_t exp2Steps[FIXED_POINT_FRACTION_BITS] = {
+    1518500250, 1276901417, 1170923762, 1121280436,
+    1097253708, 1085434106, 1079572136, 1076653033,
+    1075196443, 1074468888, 1074105294, 1073923544,
+    1073832680, 1073787251, 1073764537, 1073753181,
+    1073747502, 1073744663, 1073743244, 1073742534,
+    1073742179, 1073742001, 1073741913, 1073741868
+};
+
+/*
+ * log2 of a positive Q8.24 value, as Q8.24. The integer part comes from
+ * normalizing into [1, 2); each further bit from squaring the mantissa and
+ * checking whether it reached 2.
+ */
+static int32_t log2Fixed(uint32_t x) {
+    int32_t result = 0;
+    while (x >= (uint32_t) 2 * ONE) {
+        x >>= 1;
+        result += ONE;
+    }
+    while (x < (uint32_t) ONE) {
+        x <<= 1;
+        result -= ONE;
+    }
+    for (int32_t bit = ONE >> 1; bit > 0; bit >>= 1) {
+        x = (uint32_t) (((uint64_t) x * x) >> FIXED_POINT_FRACTION_BITS);
+        if (x >= (uint32_t) 2 * ONE) {
+            x >>= 1;
+            result += bit;
+        }
+    }
+    return result;
+}
+
+/*
+ * 2^y for a Q8.24 exponent, as Q8.24. The fraction is the product of the
+ * table entries of its set bits, the integer part a shift. Saturates above
+ * 256.
+ */
+static uint32_t exp2Fixed(int32_t y) {
+    int32_t whole = y >> FIXED_POINT_FRACTION_BITS;
+    uint32_t fraction = y & (ONE - 1);
+    uint64_t result = (uint64_t) 1 << 30;
+    for (uint8_t i = 0; i < FIXED_POINT_FRACTION_BITS; i++) {
+        if (fraction & ((uint32_t) ONE >> (i + 1))) {
+            result = (result * exp2Steps[i]) >> 30;
+        }
+    }
+    // Q2.30 to Q8.24 with rounding, then the integer part
+    int8_t shift = 30 - FIXED_POINT_FRACTION_BITS - whole;
+    if (shift <= 0) {
+        return (-shift >= 32 - 8 || result > (0xFFFFFFFFULL >> -shift)) ? 0xFFFFFFFF : (uint32_t) (result << -shift);
+    }
+    if (shift >= 63) {
+        return 0;
+    }
+    return (uint32_t) ((result + ((uint64_t) 1 << (shift - 1))) >> shift);
+}
+
+/*
+ * t^p for Q8.24 values.
+ */
+static uint32_t powFixed(uint32_t t, int32_t p) {
+    return exp2Fixed((int32_t) (((int64_t) log2Fixed(t) * p) >> FIXED_POINT_FRACTION_BITS));
+}
+
+/**
+ * @brief Constructor for the caliPileFixedPoint class.
+ */
+caliPileFixedPoint::caliPileFixedPoint() : ptat25(0), u0(0), m(0), ambientScale(0), objectScale(0), exponent(0), reciprocal(0), built(false) {
+}
+
+/**
+ * @brief Derives the integer constants for one sensor.
+ * 
+ * @param sensor A caliPile whose TempCalculations() has already been called.
+ * @return false if the calibration constants cannot be used (M is zero or UOUT1 equals U0).
+ */
+bool caliPileFixedPoint::build(const caliPile &sensor) {
+    built = false;
+    int32_t span = (int32_t) sensor.UOUT1 - (int32_t) sensor.U0;
+    if (sensor.M == 0 || span == 0) {
+        return false;
+    }
+    ptat25 = sensor.PTAT25;
+    u0 = sensor.U0;
+    m = sensor.M;
+    if (sensor.isTPiS1S()) {
+        exponent = exponent1S;
+        reciprocal = reciprocal1S;
+    } else {
+        exponent = exponent1T;
+        reciprocal = reciprocal1T;
+    }
+
+    // t_amb = 1 + (TPAMBIENT - PTAT25) / (M * 298.15), scale in Q.40
+    ambientScale = (((int64_t) 1 << 40) * 100 + (int64_t) m * FIXED_POINT_T25_CK / 2) / ((int64_t) m * FIXED_POINT_T25_CK);
+
+    // (t1^n - 1) / (UOUT1 - U0) in Q.40
+    uint32_t t1 = (uint32_t) ((((int64_t) sensor.TOBJ1 * 100 + 27315) << FIXED_POINT_FRACTION_BITS) / FIXED_POINT_T25_CK);
+    int64_t factor = (int64_t) powFixed(t1, exponent) - ONE;
+    objectScale = (factor << 16) / span;
+
+    built = true;
+    return true;
+}
+
+/**
+ * @brief Tells whether build() has been called successfully.
+ * 
+ * @return true once the constants are derived.
+ */
+bool caliPileFixedPoint::isBuilt() const {
+    return built;
+}
+
+/**
+ * @brief Converts a raw ambient reading, like caliPile::calcAmbientTemp().
+ * 
+ * @param ambientTemp The raw TPAMBIENT reading.
+ * @return The ambient temperature in centi-Kelvin.
+ */
+int32_t caliPileFixedPoint::ambientTemp(uint16_t ambientTemp) const {
+    int32_t scaled = ((int32_t) ambientTemp - ptat25) * 100;
+    int32_t half = m / 2;
+    return FIXED_POINT_T25_CK + (scaled >= 0 ? (scaled + half) / m : (scaled - half) / m);
+}
+
+/**
+ * @brief Converts a raw object reading, like caliPile::calcObjectTemp().
+ * 
+ * Takes the raw ambient reading rather than a converted temperature, so the
+ * ambient term keeps its full resolution.
+ * 
+ * @param objectTemp The raw TPOBJECT reading.
+ * @param ambientTemp The raw TPAMBIENT reading of the same cycle.
+ * @return The object temperature in centi-Kelvin, 0 if the readings imply none.
+ */
+int32_t caliPileFixedPoint::objectTemp(uint32_t objectTemp, uint16_t ambientTemp) const {
+    int64_t sum = (int64_t) powFixed(normalizedAmbient(ambientTemp), exponent);
+    sum += ((int64_t) ((int32_t) objectTemp - u0) * objectScale) >> 16;
+    if (sum <= 0) {
+        return 0;
+    }
+    if (sum > 0xFFFFFFFFLL) {
+        sum = 0xFFFFFFFFLL;
+    }
+    uint32_t t = powFixed((uint32_t) sum, reciprocal);
+    return (int32_t) (((uint64_t) t * FIXED_POINT_T25_CK + (ONE >> 1)) >> FIXED_POINT_FRACTION_BITS);
+}
+
+/**
+ * @brief Returns the ambient temperature normalized to 25 C, in Q8.24.
+ * 
+ * @param ambientTemp The raw TPAMBIENT reading.
+ * @return T / 298.15.
+ */
+uint32_t caliPileFixedPoint::normalizedAmbient(uint16_t ambientTemp) const {
+    int64_t offset = (int64_t) ((int32_t) ambientTemp - ptat25) * ambientScale;
+    int32_t t = ONE + (int32_t) (offset >> 16);
+    return t > 0 ? t : 1;
+}
@@ -0,0 +1,53 @@
+#ifndef caliPileFixedPoint_h
+#define caliPileFixedPoint_h
+
+#include "caliPile.h"
+
+// Fractional bits of the normalized temperatures and logarithms
+#define FIXED_POINT_FRACTION_BITS 24
+// 25 C in centi-Kelvin, the reference temperature of the calibration
+#define FIXED_POINT_T25_CK 29815
+
+/**
+ * @brief Integer-only temperature conversion for targets without an FPU.
+ *
+ * calcAmbientTemp() and calcObjectTemp() link in soft-float powf(), which
+ * costs several kilobytes of flash on AVR. This class returns the same
+ * temperatures in centi-Kelvin using 32/64 bit integer arithmetic only. It
+ * works on temperatures normalized to the 25 C reference, t = T / 298.15:
+ *
+ *   t_obj^n = t_amb^n + (TPOBJECT - U0) / (UOUT1 - U0) * (t1^n - 1)
+ *
+ * with t1 = (TOBJ1 + 273.15) / 298.15. This is calcObjectTemp() with k
+ * expanded from its definition in caliPile::conversionK(), so the results
+ * come from the same EEPROM constants without going through the float k.
+ * Powers are computed as 2^(n * log2(t)) in Q8.24, with log2 by repeated
+ * squaring and 2^x from a table of 2^(2^-i). TempCalculations() only
+ * decodes the integer constants, so a sketch that converts with this class
+ * alone links neither powf() nor the soft-float library.
+ *
+ * Over the whole raw input range, wherever the readings imply a temperature
+ * between 200 and 500 K, the results stay within 0.01 K of the float path:
+ * the centi-Kelvin rounding plus a few millikelvin. fixedPointTest sweeps
+ * the range on the host and checks this bound.
+ */
+class caliPileFixedPoint {
+public:
+    caliPileFixedPoint();
+    bool build(const caliPile &sensor);
+    bool isBuilt() const;
+    int32_t ambientTemp(uint16_t ambientTemp) const;
+    int32_t objectTemp(uint32_t objectTemp, uint16_t ambientTemp) const;
+
+private:
+    uint32_t normalizedAmbient(uint16_t ambientTemp) const;
+
+    int32_t ptat25, u0;
+    uint16_t m;
+    int64_t ambientScale;
+    int64_t objectScale;
+    int32_t exponent, reciprocal;
+    bool built;
+};
+
+#endif
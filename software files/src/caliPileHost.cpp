@@ -0,0 +1,86 @@
+#include "caliPile.h"
+
+#ifdef CALIPILE_LINUX
+#include <errno.h>
+#include <time.h>
+
+static uint64_t monotonicMicros() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+// Like on Arduino both clocks start near zero and wrap around
+static const uint64_t epoch = monotonicMicros();
+// Set by holdClock(); the held time only moves in delay() and delayMicroseconds()
+static bool clockHeld = false;
+static uint64_t heldMicros = 0;
+
+static uint64_t elapsedMicros() {
+    return clockHeld ? heldMicros : monotonicMicros() - epoch;
+}
+
+unsigned long millis() {
+    return (uint32_t) (elapsedMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (uint32_t) elapsedMicros();
+}
+
+void delay(unsigned long ms) {
+    if (clockHeld) {
+        heldMicros += (uint64_t) ms * 1000;
+        return;
+    }
+    struct timespec wait;
+    wait.tv_sec = ms / 1000;
+    wait.tv_nsec = (long) (ms % 1000) * 1000000L;
+    while (nanosleep(&wait, &wait) != 0 && errno == EINTR) {
+    }
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (clockHeld) {
+        heldMicros += us;
+        return;
+    }
+    struct timespec wait;
+    wait.tv_sec = us / 1000000;
+    wait.tv_nsec = (long) (us % 1000000) * 1000L;
+    while (nanosleep(&wait, &wait) != 0 && errno == EINTR) {
+    }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void) pin;
+    (void) mode;
+}
+
+int digitalRead(uint8_t pin) {
+    (void) pin;
+    return LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    (void) pin;
+    (void) value;
+}
+
+/**
+ * @brief Stops the clock for deterministic tests.
+ * 
+ * While held, millis() and micros() advance only by what delay() and
+ * delayMicroseconds() are asked to wait, and both return at once. Code that
+ * busy-waits on millis() never finishes then. Releasing the clock returns
+ * to the monotonic time. Meant for single-threaded tests.
+ * 
+ * @param held true to hold the clock at its current time.
+ */
+void holdClock(bool held) {
+    if (held && !clockHeld) {
+        heldMicros = monotonicMicros() - epoch;
+    }
+    clockHeld = held;
+}
+#endif
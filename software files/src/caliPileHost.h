@@ -0,0 +1,52 @@
+#ifndef caliPileHost_h
+#define caliPileHost_h
+
+/*
+ * The part of the Arduino API the library uses, for Linux hosts. Included
+ * by caliPile.h instead of Arduino.h when CALIPILE_LINUX is set.
+ *
+ * Time comes from CLOCK_MONOTONIC; tests can hold it with holdClock(), so
+ * only delay() moves it and clock-paced code runs the same on every run.
+ * GPIOs are not driven: pinMode() and
+ * digitalWrite() do nothing and digitalRead() reports LOW, so code that
+ * waits for the INT pin (readTimedSnapshot(), caliPileRing) reads
+ * INTERRUPT_STATUS on every call instead.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void holdClock(bool held);
+
+/**
+ * @brief Byte sink with the Arduino Print interface, e.g. for caliPileCaptureWriter.
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *data, size_t count) {
+        size_t written = 0;
+        while (written < count && write(data[written])) {
+            written++;
+        }
+        return written;
+    }
+};
+
+#endif
@@ -0,0 +1,270 @@
+#include "caliPileLinuxI2C.h"
+
+#ifdef CALIPILE_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+static int systemOpen(const char *path, int flags) {
+    return open(path, flags);
+}
+
+static int systemIoctl(int fd, unsigned long request, void *argument) {
+    return ioctl(fd, request, argument);
+}
+
+static int systemClose(int fd) {
+    return close(fd);
+}
+
+// Set by the last transfer of the calling thread, read back by timedOut()
+static thread_local bool lastTimedOut = false;
+// write() style result of the calling thread's last writeRead()
+static thread_local uint8_t lastPointerStatus = 0;
+
+// Maps the errno of a failed I2C_RDWR to an endTransmission() style code
+static uint8_t errnoStatus() {
+    if (errno == ETIMEDOUT) {
+        return 5;
+    }
+    if (errno == ENXIO || errno == EREMOTEIO || errno == EIO) {
+        return 2;
+    }
+    return 4;
+}
+
+/**
+ * @brief Constructor for the i2c-dev transport.
+ * 
+ * @param devicePath The adapter node, e.g. "/dev/i2c-1".
+ */
+caliPileLinuxI2C::caliPileLinuxI2C(const char *devicePath) : calls(systemCalls()), fd(-1), timeout(BUS_TIMEOUT_US) {
+    strncpy(path, devicePath, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+}
+
+/**
+ * @brief Constructor for the i2c-dev transport with replaced system calls.
+ * 
+ * @param devicePath The adapter node, e.g. "/dev/i2c-1".
+ * @param replacement The calls to use instead of open(), ioctl() and close(),
+ *                    e.g. caliPileFakeI2C::calls().
+ */
+caliPileLinuxI2C::caliPileLinuxI2C(const char *devicePath, const caliPileI2CCalls &replacement) : calls(replacement), fd(-1), timeout(BUS_TIMEOUT_US) {
+    strncpy(path, devicePath, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+}
+
+/**
+ * @brief Destructor, closes the adapter node.
+ */
+caliPileLinuxI2C::~caliPileLinuxI2C() {
+    end();
+}
+
+/**
+ * @brief The real system calls, used unless others are given.
+ * 
+ * @return open(), ioctl() and close() of the C library.
+ */
+const caliPileI2CCalls &caliPileLinuxI2C::systemCalls() {
+    static const caliPileI2CCalls calls = {systemOpen, systemIoctl, systemClose};
+    return calls;
+}
+
+/**
+ * @brief Opens the adapter node.
+ * 
+ * Needs read and write access to the node, e.g. membership of the i2c group.
+ * 
+ * @return true if the node is open.
+ */
+bool caliPileLinuxI2C::begin() {
+    std::lock_guard<std::mutex> guard(lock);
+    return openNode();
+}
+
+/**
+ * @brief Closes the adapter node.
+ */
+void caliPileLinuxI2C::end() {
+    std::lock_guard<std::mutex> guard(lock);
+    closeNode();
+}
+
+/**
+ * @brief Tells whether the adapter node is open.
+ * 
+ * @return true after a successful begin().
+ */
+bool caliPileLinuxI2C::isOpen() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return fd >= 0;
+}
+
+/**
+ * @brief Writes a block of bytes to a device in one I2C_RDWR transfer.
+ * 
+ * @param address The address of the device.
+ * @param data The bytes to be written, starting with the register address.
+ * @param count The number of bytes to be written.
+ * @return 0 on success, 2 if the device did not acknowledge, 5 on timeout,
+ *         4 on any other error, like Wire.endTransmission().
+ */
+uint8_t caliPileLinuxI2C::write(uint8_t address, const uint8_t *data, uint8_t count) {
+    struct i2c_msg message;
+    message.addr = address;
+    message.flags = 0;
+    message.len = count;
+    message.buf = const_cast<uint8_t *>(data);
+    if (transfer(&message, 1) == 0) {
+        return 0;
+    }
+    return errnoStatus();
+}
+
+/**
+ * @brief Writes a register pointer and reads back a block of bytes.
+ * 
+ * Both messages go in one I2C_RDWR transfer, so the read follows with a
+ * repeated START in the same system call.
+ * 
+ * @param address The address of the device.
+ * @param reg The first register to be read.
+ * @param target Pointer to an array where the read data will be stored.
+ * @param count The number of bytes to be read.
+ * @return The number of bytes read, count or 0; pointerStatus() tells why it failed.
+ */
+uint8_t caliPileLinuxI2C::writeRead(uint8_t address, uint8_t reg, uint8_t *target, uint8_t count) {
+    struct i2c_msg messages[2];
+    messages[0].addr = address;
+    messages[0].flags = 0;
+    messages[0].len = 1;
+    messages[0].buf = &reg;
+    messages[1].addr = address;
+    messages[1].flags = I2C_M_RD;
+    messages[1].len = count;
+    messages[1].buf = target;
+    if (transfer(messages, 2) != 0) {
+        lastPointerStatus = errnoStatus();
+        return 0;
+    }
+    lastPointerStatus = 0;
+    return count;
+}
+
+/**
+ * @brief Returns why the calling thread's last writeRead() failed.
+ * 
+ * Both messages share one transfer, so a NACK of the device address is
+ * reported here whichever message it hit.
+ * 
+ * @return 0 after a successful read, otherwise the write() style error code.
+ */
+uint8_t caliPileLinuxI2C::pointerStatus() {
+    return lastPointerStatus;
+}
+
+/**
+ * @brief Sets the adapter timeout (I2C_TIMEOUT, 10 ms granularity).
+ * 
+ * @param timeoutMicros The limit per transfer in microseconds, 0 keeps the adapter default.
+ */
+void caliPileLinuxI2C::setTimeout(uint32_t timeoutMicros) {
+    std::lock_guard<std::mutex> guard(lock);
+    timeout = timeoutMicros;
+    applyTimeout();
+}
+
+/**
+ * @brief Tells whether the calling thread's last transfer timed out.
+ * 
+ * @return true if the adapter reported ETIMEDOUT.
+ */
+bool caliPileLinuxI2C::timedOut() {
+    bool result = lastTimedOut;
+    lastTimedOut = false;
+    return result;
+}
+
+/**
+ * @brief Reopens the adapter node.
+ * 
+ * SCL cannot be clocked from user space; adapters that support bus
+ * recovery run it in the kernel driver when a transfer times out. Reopening
+ * drops any state the node holds. Transfers of other threads wait until
+ * the node is open again.
+ * 
+ * @return true if the node could be opened again.
+ */
+bool caliPileLinuxI2C::recover() {
+    std::lock_guard<std::mutex> guard(lock);
+    closeNode();
+    return openNode();
+}
+
+/**
+ * @brief Runs one combined transfer.
+ * 
+ * Opens the node on first use.
+ * 
+ * @param messages The i2c_msg array.
+ * @param count The number of messages.
+ * @return 0 on success, -1 with errno set otherwise.
+ */
+int caliPileLinuxI2C::transfer(void *messages, uint8_t count) {
+    lastTimedOut = false;
+    std::lock_guard<std::mutex> guard(lock);
+    if (!openNode()) {
+        return -1;
+    }
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = (struct i2c_msg *) messages;
+    data.nmsgs = count;
+    if (calls.ioctl(fd, I2C_RDWR, &data) < 0) {
+        lastTimedOut = errno == ETIMEDOUT;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Opens the node unless it is open; the caller holds the lock.
+ * 
+ * @return true if the node is open.
+ */
+bool caliPileLinuxI2C::openNode() {
+    if (fd >= 0) {
+        return true;
+    }
+    fd = calls.open(path, O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    applyTimeout();
+    return true;
+}
+
+/**
+ * @brief Closes the node if it is open; the caller holds the lock.
+ */
+void caliPileLinuxI2C::closeNode() {
+    if (fd >= 0) {
+        calls.close(fd);
+        fd = -1;
+    }
+}
+
+/**
+ * @brief Hands the timeout to the open node; the caller holds the lock.
+ */
+void caliPileLinuxI2C::applyTimeout() {
+    if (fd >= 0 && timeout != 0) {
+        unsigned long ticks = (timeout + 9999) / 10000;
+        calls.ioctl(fd, I2C_TIMEOUT, (void *) ticks);
+    }
+}
+#endif
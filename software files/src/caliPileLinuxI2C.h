@@ -0,0 +1,70 @@
+#ifndef caliPileLinuxI2C_h
+#define caliPileLinuxI2C_h
+
+#include "caliPile.h"
+
+#ifdef CALIPILE_LINUX
+#include <mutex>
+
+/**
+ * @brief The system calls caliPileLinuxI2C makes, replaceable for testing.
+ *
+ * The default set is the real open(), ioctl() and close(); caliPileFakeI2C
+ * provides one that emulates sensors behind an i2c-dev node.
+ */
+struct caliPileI2CCalls {
+    int (*open)(const char *path, int flags);
+    int (*ioctl)(int fd, unsigned long request, void *argument);
+    int (*close)(int fd);
+};
+
+/**
+ * @brief caliPileBus over a Linux i2c-dev node such as /dev/i2c-1.
+ *
+ * Every transfer is one I2C_RDWR ioctl; a register read sends the pointer
+ * write and the read as two messages of one combined transfer, joined by a
+ * repeated START, in a single system call.
+ *
+ * Create one instance per adapter and hand it to every caliPile on that
+ * bus, also when they run on different threads, e.g. one worker per
+ * sensor: the sensors then share the reload counter, so each learns of a
+ * general call sent by another. Transfers and recover(), which reopens the
+ * node, are serialized by a mutex; timedOut() and pointerStatus() report
+ * the calling thread's last transfer.
+ */
+class caliPileLinuxI2C : public caliPileBus {
+public:
+    caliPileLinuxI2C(const char *devicePath);
+    caliPileLinuxI2C(const char *devicePath, const caliPileI2CCalls &replacement);
+    ~caliPileLinuxI2C();
+    static const caliPileI2CCalls &systemCalls();
+    bool begin();
+    void end();
+    bool isOpen() const;
+    uint8_t write(uint8_t address, const uint8_t *data, uint8_t count);
+    uint8_t writeRead(uint8_t address, uint8_t reg, uint8_t *target, uint8_t count);
+    uint8_t pointerStatus();
+    void setTimeout(uint32_t timeoutMicros);
+    bool timedOut();
+    bool recover();
+
+private:
+    caliPileLinuxI2C(const caliPileLinuxI2C &);
+    caliPileLinuxI2C &operator=(const caliPileLinuxI2C &);
+
+    int transfer(void *messages, uint8_t count);
+    bool openNode();
+    void closeNode();
+    void applyTimeout();
+
+    char path[64];
+    caliPileI2CCalls calls;
+    int fd;
+    uint32_t timeout;
+    // Held by every use of fd
+    mutable std::mutex lock;
+};
+
+#endif
+
+#endif
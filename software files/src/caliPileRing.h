@@ -0,0 +1,154 @@
+#ifndef caliPileRing_h
+#define caliPileRing_h
+
+#include "caliPile.h"
+
+// Cores with a C++11 library get acquire/release ring indices; AVR has none
+#if defined(__has_include)
+#if __has_include(<atomic>)
+#include <atomic>
+#define CALIPILE_RING_ATOMIC
+#endif
+#endif
+
+/**
+ * @brief One timestamped conversion result as stored in a caliPileRing.
+ */
+struct caliPileSample {
+    uint32_t timestamp;
+    caliPileSnapshot snapshot;
+};
+
+/**
+ * @brief Statically allocated ring of samples, filled in the background.
+ *
+ * service() is called from loop() (or a sampling task). Whenever the
+ * sensor's INT pin is asserted, typically by the timer set with
+ * caliPile::initTimer(), it reads the result block straight into the next
+ * free slot, so each cycle is stored once and never copied. The consumer
+ * borrows the oldest samples as one contiguous span, transmits them in
+ * place and releases them afterwards; a batch of many cycles can go out in
+ * one radio wake-up. Borrowed slots are never overwritten: while the ring
+ * is full new results are read (to release the INT pin) and counted in
+ * dropped().
+ *
+ * There is one producer (service()) and one consumer (borrow() and
+ * release()). Where <atomic> is available (ARM and ESP32 cores, Linux) the
+ * indices are published with release and read with acquire ordering, so
+ * the two may run in different tasks or threads, also on different cores.
+ * Without it (AVR) the indices are volatile with compiler barriers, which
+ * only orders a single context: call both from loop(), not from an ISR,
+ * whose reads of the 16-bit indices would not be atomic.
+ *
+ * Size must be a power of two, at most 32768.
+ */
+template <uint16_t Size>
+class caliPileRing {
+    static_assert(Size > 0 && Size <= 32768 && (Size & (Size - 1)) == 0, "caliPileRing size must be a power of two");
+
+public:
+    caliPileRing(caliPile &ringSensor) : sensor(ringSensor), head(0), tail(0), overflows(0) {
+    }
+
+    /**
+     * @brief Stores a new sample if the INT pin is asserted.
+     * 
+     * @return true if a sample was added to the ring.
+     */
+    bool service() {
+        uint16_t next = head;
+        if ((uint16_t) (next - acquire(tail)) == Size) {
+            caliPileSnapshot discard;
+            if (sensor.readTimedSnapshot(discard)) {
+                overflows++;
+            }
+            return false;
+        }
+        caliPileSample &slot = samples[next & (Size - 1)];
+        if (!sensor.readTimedSnapshot(slot.snapshot)) {
+            return false;
+        }
+        slot.timestamp = millis();
+        publish(head, next + 1);
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of stored samples not yet released.
+     */
+    uint16_t available() const {
+        return acquire(head) - tail;
+    }
+
+    /**
+     * @brief Lends the oldest samples without copying them.
+     * 
+     * The span ends where the ring wraps, so call again after release() to
+     * get the rest.
+     * 
+     * @param span Output, points to the first sample of the span.
+     * @return The number of consecutive samples at span, 0 if the ring is empty.
+     */
+    uint16_t borrow(const caliPileSample *&span) const {
+        uint16_t first = tail;
+        uint16_t count = acquire(head) - first;
+        uint16_t index = first & (Size - 1);
+        if (count > Size - index) {
+            count = Size - index;
+        }
+        span = &samples[index];
+        return count;
+    }
+
+    /**
+     * @brief Hands borrowed samples back to the ring.
+     * 
+     * @param count The number of samples consumed, at most the size of the last span.
+     */
+    void release(uint16_t count) {
+        uint16_t first = tail;
+        uint16_t stored = acquire(head) - first;
+        publish(tail, first + (count < stored ? count : stored));
+    }
+
+    /**
+     * @brief Returns the number of results read while the ring was full.
+     */
+    uint32_t dropped() const {
+        return overflows;
+    }
+
+private:
+#ifdef CALIPILE_RING_ATOMIC
+    typedef std::atomic<uint16_t> index;
+
+    static uint16_t acquire(const index &position) {
+        return position.load(std::memory_order_acquire);
+    }
+
+    static void publish(index &position, uint16_t value) {
+        position.store(value, std::memory_order_release);
+    }
+#else
+    typedef volatile uint16_t index;
+
+    static uint16_t acquire(const index &position) {
+        uint16_t value = position;
+        __asm__ __volatile__("" ::: "memory");
+        return value;
+    }
+
+    static void publish(index &position, uint16_t value) {
+        __asm__ __volatile__("" ::: "memory");
+        position = value;
+    }
+#endif
+
+    caliPile &sensor;
+    caliPileSample samples[Size];
+    index head;
+    index tail;
+    uint32_t overflows;
+};
+
+#endif
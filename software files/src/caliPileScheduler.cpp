@@ -0,0 +1,146 @@
+#include "caliPileScheduler.h"
+
+/**
+ * @brief Constructor for the caliPileScheduler class.
+ * 
+ * @param scheduledSensor The sensor whose sampling is adapted.
+ */
+caliPileScheduler::caliPileScheduler(caliPile &scheduledSensor) : sensor(scheduledSensor), current(0), enterCount(1), activeCount(0),
+        hold(SCHEDULER_HOLD_MS), lastPoll(0), lastActivity(0), woken(false) {
+    setLevel(0, ms30, 30, 0);
+    setLevel(1, ms60, 120, 0);
+    setLevel(2, ms120, 500, INT_PRESENCE | INT_MOTION);
+    setLevel(3, ms240, 2000, INT_PRESENCE | INT_MOTION);
+}
+
+/**
+ * @brief Replaces the settings of one level.
+ * 
+ * A poll interval shorter than the cycle time may see the same TP_MOTION twice.
+ * 
+ * @param index The level, 0 (fastest) to SCHEDULER_LEVELS - 1.
+ * @param cycleTime The motion cycle time (ms30, ms60, ms120, ms240).
+ * @param pollMs The interval between host reads, in ms.
+ * @param interruptMask INT_PRESENCE and INT_MOTION to enable on this level.
+ *        Other INT_* flags are ignored.
+ */
+void caliPileScheduler::setLevel(uint8_t index, uint8_t cycleTime, uint16_t pollMs, uint8_t interruptMask) {
+    if (index >= SCHEDULER_LEVELS) {
+        return;
+    }
+    levels[index].cycleTime = cycleTime & 0x03;
+    levels[index].pollMs = pollMs;
+    levels[index].interruptMask = interruptMask & SCHEDULER_ACTIVITY;
+}
+
+/**
+ * @brief Sets how eagerly the scheduler changes level.
+ * 
+ * @param enteringSamples Consecutive samples with activity needed to return
+ *        to level 0. 1 reacts to the first one; higher values ignore single
+ *        spurious detections. An interrupt passed to wake() always counts.
+ * @param holdMs Time without activity before each step to a slower level.
+ */
+void caliPileScheduler::setHysteresis(uint8_t enteringSamples, uint32_t holdMs) {
+    enterCount = enteringSamples ? enteringSamples : 1;
+    hold = holdMs;
+}
+
+/**
+ * @brief Starts at level 0.
+ * 
+ * Call after initMotion(), which sets the LP times and thresholds.
+ */
+void caliPileScheduler::begin() {
+    if (!sensor.isConfigKnown(SRC_SELECT) || !sensor.isConfigKnown(INT_MASK)) {
+        sensor.syncConfig();
+    }
+    lastActivity = millis();
+    lastPoll = lastActivity - levels[0].pollMs;
+    activeCount = 0;
+    apply(0);
+}
+
+/**
+ * @brief Requests a read at the next service() call.
+ * 
+ * Safe to call from the ISR attached to the INT pin.
+ */
+void caliPileScheduler::wake() {
+    woken = true;
+}
+
+/**
+ * @brief Reads the sensor when due and adapts the level.
+ * 
+ * Call from loop(). Between due times it returns at once without bus
+ * traffic; millisUntilDue() tells how long the host may sleep.
+ * 
+ * @param snapshot Receives the result block when a read was made.
+ * @return true if snapshot holds a new sample.
+ */
+bool caliPileScheduler::service(caliPileSnapshot &snapshot) {
+    uint32_t now = millis();
+    bool interrupted = woken;
+    if (!interrupted && now - lastPoll < levels[current].pollMs) {
+        return false;
+    }
+    woken = false;
+    lastPoll = now;
+    sensor.readSnapshot(snapshot);
+
+    // INTERRUPT_STATUS holds what fired since the last read, CHIP_STATUS what is active now
+    uint8_t activity = (snapshot.interruptStatus() | snapshot.chipStatus()) & SCHEDULER_ACTIVITY;
+    if (activity) {
+        lastActivity = now;
+        if (activeCount < enterCount) {
+            activeCount++;
+        }
+        if (current > 0 && (activeCount >= enterCount || interrupted)) {
+            apply(0);
+        }
+    } else {
+        activeCount = 0;
+        if (current < SCHEDULER_LEVELS - 1 && now - lastActivity >= hold) {
+            lastActivity = now;
+            apply(current + 1);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the current level.
+ * 
+ * @return 0 (fastest) to SCHEDULER_LEVELS - 1.
+ */
+uint8_t caliPileScheduler::level() const {
+    return current;
+}
+
+/**
+ * @brief Returns the time until service() will read the sensor.
+ * 
+ * @return Milliseconds until the next poll, 0 if one is due.
+ */
+uint32_t caliPileScheduler::millisUntilDue() const {
+    uint32_t elapsed = millis() - lastPoll;
+    if (woken || elapsed >= levels[current].pollMs) {
+        return 0;
+    }
+    return levels[current].pollMs - elapsed;
+}
+
+/**
+ * @brief Writes the cycle time and interrupt mask of a level to the sensor.
+ * 
+ * Only SRC_SELECT[1:0] and the SCHEDULER_ACTIVITY bits of INT_MASK change.
+ * 
+ * @param index The level to switch to.
+ */
+void caliPileScheduler::apply(uint8_t index) {
+    current = index;
+    sensor.setConfig(SRC_SELECT, (sensor.configValue(SRC_SELECT) & ~0x03) | levels[index].cycleTime);
+    sensor.setConfig(INT_MASK, (sensor.configValue(INT_MASK) & ~SCHEDULER_ACTIVITY) | levels[index].interruptMask);
+    sensor.flushConfig();
+}
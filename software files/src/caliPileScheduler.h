@@ -0,0 +1,77 @@
+#ifndef caliPileScheduler_h
+#define caliPileScheduler_h
+
+#include "caliPile.h"
+
+// Sampling levels, from fastest (someone present) to slowest (room empty)
+#define SCHEDULER_LEVELS 4
+// Default time without activity before stepping one level slower
+#define SCHEDULER_HOLD_MS 10000
+// Conditions that count as activity
+#define SCHEDULER_ACTIVITY (INT_PRESENCE | INT_MOTION)
+
+/**
+ * @brief One sampling level: motion cycle time, host poll interval and the
+ *        SCHEDULER_ACTIVITY bits of INT_MASK.
+ */
+struct caliPileSchedulerLevel {
+    uint8_t cycleTime;
+    uint16_t pollMs;
+    uint8_t interruptMask;
+};
+
+/**
+ * @brief Adapts sampling rate and power to presence and motion activity.
+ *
+ * Level 0 polls every 30 ms while someone is present. Each time the space
+ * stays quiet for the hold time the scheduler steps one level slower: fewer
+ * host polls, and at the slow levels the presence and motion interrupts
+ * enabled so the INT pin wakes the host instead of polling. Activity in
+ * enteringSamples consecutive samples, or any interrupt passed to wake(),
+ * jumps straight back to level 0, so entry events are never waited out.
+ *
+ * The sensor converts at the same rate on every level; only the host polls
+ * less. The cycle time in SRC_SELECT[1:0] is not a sampling rate but the
+ * interval between the two TP_OBJLP1 points TP_MOTION is the difference of.
+ * The quiet levels lengthen it so a slow entry still builds up enough
+ * TP_MOTION to cross the TP_MOT_THLD set by initMotion() and raise the
+ * interrupt; level 0 keeps it short so motion follows quick movement. The
+ * same threshold is thus more sensitive on the quiet levels.
+ *
+ * Levels are applied through the configuration shadow, so only changed
+ * registers are written. A level owns only the SCHEDULER_ACTIVITY bits of
+ * INT_MASK; the others, e.g. INT_TIMER, are left as they are. The defaults
+ * are:
+ *
+ *   level  cycle  poll     INT_MASK
+ *   0      ms30   30 ms    -
+ *   1      ms60   120 ms   -
+ *   2      ms120  500 ms   presence, motion
+ *   3      ms240  2000 ms  presence, motion
+ */
+class caliPileScheduler {
+public:
+    caliPileScheduler(caliPile &scheduledSensor);
+    void setLevel(uint8_t index, uint8_t cycleTime, uint16_t pollMs, uint8_t interruptMask);
+    void setHysteresis(uint8_t enteringSamples, uint32_t holdMs);
+    void begin();
+    void wake();
+    bool service(caliPileSnapshot &snapshot);
+    uint8_t level() const;
+    uint32_t millisUntilDue() const;
+
+private:
+    caliPile &sensor;
+    caliPileSchedulerLevel levels[SCHEDULER_LEVELS];
+    uint8_t current;
+    uint8_t enterCount;
+    uint8_t activeCount;
+    uint32_t hold;
+    uint32_t lastPoll;
+    uint32_t lastActivity;
+    volatile bool woken;
+
+    void apply(uint8_t index);
+};
+
+#endif
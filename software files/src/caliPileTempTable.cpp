@@ -0,0 +1,100 @@
+#include "caliPileTempTable.h"
+
+static const float tableStep = (TEMP_TABLE_MAX_K - TEMP_TABLE_MIN_K) / (TEMP_TABLE_SIZE - 1);
+static const float invTableStep = (TEMP_TABLE_SIZE - 1) / (TEMP_TABLE_MAX_K - TEMP_TABLE_MIN_K);
+
+/**
+ * @brief Constructor for the caliPileTempTable class.
+ * 
+ * The table is empty until build() is called.
+ */
+caliPileTempTable::caliPileTempTable() : exponent(0), ptat25(0), invM(0), u0(0), invK(0), built(false) {
+}
+
+/**
+ * @brief Fills the table for one sensor.
+ * 
+ * This function copies the calibration constants of the sensor and evaluates
+ * T^n at every knot. It costs TEMP_TABLE_SIZE powf() calls and has to be
+ * repeated if the sensor is recalibrated.
+ * 
+ * @param sensor A caliPile whose TempCalculations() has already been called.
+ */
+void caliPileTempTable::build(const caliPile &sensor) {
+    exponent = sensor.exponent();
+    ptat25 = (float) sensor.PTAT25;
+    invM = 1.0f / (float) sensor.M;
+    u0 = (float) sensor.U0;
+    invK = 1.0f / sensor.conversionK();
+    for (uint8_t i = 0; i < TEMP_TABLE_SIZE; i++) {
+        power[i] = powf(TEMP_TABLE_MIN_K + i * tableStep, exponent);
+    }
+    built = true;
+}
+
+/**
+ * @brief Tells whether build() has been called.
+ * 
+ * @return true once the table holds data.
+ */
+bool caliPileTempTable::isBuilt() const {
+    return built;
+}
+
+/**
+ * @brief Calculates the ambient temperature from the raw ambient temperature reading.
+ * 
+ * Same formula as caliPile::calcAmbientTemp(), using the copied constants.
+ * 
+ * @param ambientTemp The raw ambient temperature reading.
+ * @return The calculated ambient temperature in degrees Kelvin.
+ */
+float caliPileTempTable::ambientTemp(uint16_t ambientTemp) const {
+    return 298.15f + ((float)ambientTemp - ptat25) * invM;
+}
+
+/**
+ * @brief Calculates the object temperature with the table instead of powf().
+ * 
+ * @param objectTemp The raw object temperature reading.
+ * @param ambientTemp The calculated ambient temperature in degrees Kelvin.
+ * @return The calculated object temperature in degrees Kelvin.
+ */
+float caliPileTempTable::objectTemp(uint32_t objectTemp, float ambientTemp) const {
+    float temp1 = (((float) objectTemp) - u0) * invK;
+    return rootOf(powerOf(ambientTemp) + temp1);
+}
+
+/**
+ * @brief Interpolates temp^n between the two surrounding knots.
+ */
+float caliPileTempTable::powerOf(float temp) const {
+    float position = (temp - TEMP_TABLE_MIN_K) * invTableStep;
+    if (!(position >= 0.0f) || position >= (float) (TEMP_TABLE_SIZE - 1)) {
+        return powf(temp, exponent);
+    }
+    uint8_t i = (uint8_t) position;
+    float fraction = position - i;
+    return power[i] + (power[i + 1] - power[i]) * fraction;
+}
+
+/**
+ * @brief Finds the knots around power by bisection and interpolates the temperature.
+ */
+float caliPileTempTable::rootOf(float value) const {
+    if (!(value >= power[0]) || value >= power[TEMP_TABLE_SIZE - 1]) {
+        return powf(value, 1.0f / exponent);
+    }
+    uint8_t low = 0;
+    uint8_t high = TEMP_TABLE_SIZE - 1;
+    while (high - low > 1) {
+        uint8_t middle = (low + high) / 2;
+        if (power[middle] <= value) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    float fraction = (value - power[low]) / (power[high] - power[low]);
+    return TEMP_TABLE_MIN_K + (low + fraction) * tableStep;
+}
@@ -0,0 +1,46 @@
+#ifndef caliPileTempTable_h
+#define caliPileTempTable_h
+
+#include "caliPile.h"
+
+// Number of knots in the T^n table and the Kelvin range they cover
+#define TEMP_TABLE_SIZE 65
+#define TEMP_TABLE_MIN_K 233.15f
+#define TEMP_TABLE_MAX_K 393.15f
+
+/**
+ * @brief Precomputed fast path for caliPile::calcObjectTemp().
+ *
+ * calcObjectTemp() needs two powf() calls per sample. This table stores
+ * T^n for TEMP_TABLE_SIZE evenly spaced temperatures between TEMP_TABLE_MIN_K
+ * and TEMP_TABLE_MAX_K (-40 C .. +120 C) and replaces both calls with a
+ * linear interpolation: a direct lookup for the ambient term and a binary
+ * search for the inverse. It is built once per device after
+ * caliPile::TempCalculations() has loaded U0, PTAT25 and M.
+ *
+ * Maximum error versus calcObjectTemp() with the default 65 knots (2.5 K
+ * spacing), ambient and object temperature both inside the table range:
+ *   exponent 3.8: 0.022 K
+ *   exponent 4.2: 0.031 K
+ * The worst case is a cold object seen from a hot sensor. The error shrinks
+ * with the square of the knot spacing. Values outside the range fall back
+ * to the exact formula.
+ */
+class caliPileTempTable {
+public:
+    caliPileTempTable();
+    void build(const caliPile &sensor);
+    bool isBuilt() const;
+    float ambientTemp(uint16_t ambientTemp) const;
+    float objectTemp(uint32_t objectTemp, float ambientTemp) const;
+
+private:
+    float powerOf(float temp) const;
+    float rootOf(float power) const;
+
+    float power[TEMP_TABLE_SIZE];
+    float exponent, ptat25, invM, u0, invK;
+    bool built;
+};
+
+#endif